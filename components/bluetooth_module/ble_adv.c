@@ -0,0 +1,253 @@
+// components/bluetooth_module/ble_adv.c
+#include "ble_adv.h"
+#include <string.h>
+
+static inline uint16_t le16(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+static inline uint16_t be16(const uint8_t *p) {
+    return p[0] << 8 | p[1];
+}
+
+static inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+void ble_ad_iter_init(ble_ad_iter_t *it, const uint8_t *data, size_t len) {
+    it->pos = data;
+    it->end = data + len;
+    it->malformed = false;
+}
+
+bool ble_ad_next(ble_ad_iter_t *it, ble_ad_t *ad) {
+    if (it->pos >= it->end) return false;
+    uint8_t len = it->pos[0];
+    if (len == 0) return false;             // Padding to the end
+    if (len > it->end - it->pos - 1) {
+        it->malformed = true;
+        return false;
+    }
+    ad->type = it->pos[1];
+    ad->len = len - 1;
+    ad->data = it->pos + 2;
+    it->pos += len + 1;
+    return true;
+}
+
+void ble_adv_info_init(ble_adv_info_t *info) {
+    memset(info, 0, sizeof(*info));
+    info->flags = -1;
+}
+
+// First occurrence wins; a list is only taken whole
+static void take_list(const ble_ad_t *ad, size_t size, const uint8_t **list, uint8_t *count) {
+    if (*list == NULL && ad->len >= size) {
+        *list = ad->data;
+        *count = ad->len / size;
+    }
+}
+
+esp_err_t ble_adv_parse(ble_adv_info_t *info, const uint8_t *data, size_t len) {
+    ble_ad_iter_t it;
+    ble_ad_t ad;
+    ble_ad_iter_init(&it, data, len);
+
+    while (ble_ad_next(&it, &ad)) {
+        info->num_ad++;
+        switch (ad.type) {
+            case BLE_AD_FLAGS:
+                if (info->flags < 0 && ad.len >= 1) info->flags = ad.data[0];
+                break;
+            case BLE_AD_NAME_SHORT:
+            case BLE_AD_NAME_COMPLETE:
+                // A complete name replaces a shortened one
+                if (info->name == NULL || (!info->name_complete && ad.type == BLE_AD_NAME_COMPLETE)) {
+                    info->name = (const char *)ad.data;
+                    info->name_len = ad.len;
+                    info->name_complete = ad.type == BLE_AD_NAME_COMPLETE;
+                }
+                break;
+            case BLE_AD_TX_POWER:
+                if (!info->has_tx_power && ad.len >= 1) {
+                    info->has_tx_power = true;
+                    info->tx_power = (int8_t)ad.data[0];
+                }
+                break;
+            case BLE_AD_UUID16_INCOMPLETE:
+            case BLE_AD_UUID16_COMPLETE:
+                take_list(&ad, 2, &info->uuid16, &info->num_uuid16);
+                break;
+            case BLE_AD_UUID32_INCOMPLETE:
+            case BLE_AD_UUID32_COMPLETE:
+                take_list(&ad, 4, &info->uuid32, &info->num_uuid32);
+                break;
+            case BLE_AD_UUID128_INCOMPLETE:
+            case BLE_AD_UUID128_COMPLETE:
+                take_list(&ad, 16, &info->uuid128, &info->num_uuid128);
+                break;
+            case BLE_AD_MANUFACTURER:
+                if (info->mfr_data == NULL && ad.len >= 2) {
+                    info->company_id = le16(ad.data);
+                    info->mfr_data = ad.data + 2;
+                    info->mfr_len = ad.len - 2;
+                }
+                break;
+            case BLE_AD_SERVICE_DATA16:
+                if (info->svc_data == NULL && ad.len >= 2) {
+                    info->svc_uuid16 = le16(ad.data);
+                    info->svc_data = ad.data + 2;
+                    info->svc_len = ad.len - 2;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return it.malformed ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+bool ble_adv_ibeacon(const ble_adv_info_t *info, ble_ibeacon_t *out) {
+    // Type 0x02, length 0x15: UUID, major, minor, measured power
+    const uint8_t *d = info->mfr_data;
+    if (d == NULL || info->company_id != BLE_COMPANY_APPLE || info->mfr_len < 23 ||
+        d[0] != 0x02 || d[1] != 0x15) {
+        return false;
+    }
+    out->uuid = d + 2;
+    out->major = be16(d + 18);
+    out->minor = be16(d + 20);
+    out->measured_power = (int8_t)d[22];
+    return true;
+}
+
+bool ble_adv_eddystone(const ble_adv_info_t *info, ble_eddystone_t *out) {
+    const uint8_t *d = info->svc_data;
+    uint8_t len = info->svc_len;
+    if (d == NULL || info->svc_uuid16 != BLE_UUID_EDDYSTONE || len < 2) return false;
+
+    out->frame = d[0];
+    out->tx_power = (int8_t)d[1];
+    switch (d[0]) {
+        case BLE_EDDYSTONE_UID:
+            if (len < 18) return false;
+            out->uid.namespace_id = d + 2;
+            out->uid.instance_id = d + 12;
+            return true;
+        case BLE_EDDYSTONE_URL:
+            if (len < 3) return false;
+            out->url.encoded = d + 2;
+            out->url.len = len - 2;
+            return true;
+        case BLE_EDDYSTONE_TLM:
+            // Unencrypted version 0 only
+            if (len < 14 || d[1] != 0x00) return false;
+            out->tx_power = 0;
+            out->tlm.battery_mv = be16(d + 2);
+            out->tlm.temp_q8 = (int16_t)be16(d + 4);
+            out->tlm.adv_count = be32(d + 6);
+            out->tlm.uptime_ds = be32(d + 10);
+            return true;
+        case BLE_EDDYSTONE_EID:
+            if (len < 10) return false;
+            out->eid.eid = d + 2;
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t ble_eddystone_url(const ble_eddystone_t *frame, char *out, size_t size) {
+    static const char *const SCHEMES[] = {"http://www.", "https://www.", "http://", "https://"};
+    static const char *const EXPANSIONS[] = {
+        ".com/", ".org/", ".edu/", ".net/", ".info/", ".biz/", ".gov/",
+        ".com", ".org", ".edu", ".net", ".info", ".biz", ".gov",
+    };
+    size_t n = 0;
+
+    // Append, counting what does not fit
+#define URL_PUT(s, l) do {                                  \
+        size_t l_ = (l);                                    \
+        if (n < size) {                                     \
+            size_t room_ = size - 1 - n;                    \
+            memcpy(out + n, (s), l_ < room_ ? l_ : room_);  \
+        }                                                   \
+        n += l_;                                            \
+    } while (0)
+
+    const uint8_t *p = frame->url.encoded;
+    uint8_t scheme = p[0];
+    if (scheme < 4) URL_PUT(SCHEMES[scheme], strlen(SCHEMES[scheme]));
+    for (uint8_t i = 1; i < frame->url.len; i++) {
+        if (p[i] < 14) {
+            URL_PUT(EXPANSIONS[p[i]], strlen(EXPANSIONS[p[i]]));
+        } else if (p[i] > 0x20 && p[i] < 0x7f) {
+            URL_PUT(&p[i], 1);
+        }
+    }
+#undef URL_PUT
+
+    if (size > 0) out[n < size ? n : size - 1] = '\0';
+    return n;
+}
+
+bool ble_continuity_iter_init(ble_continuity_iter_t *it, const ble_adv_info_t *info) {
+    if (info->mfr_data == NULL || info->company_id != BLE_COMPANY_APPLE) return false;
+    it->pos = info->mfr_data;
+    it->end = info->mfr_data + info->mfr_len;
+    return true;
+}
+
+bool ble_continuity_next(ble_continuity_iter_t *it, uint8_t *type, const uint8_t **data,
+                         uint8_t *len) {
+    if (it->end - it->pos < 2) return false;
+    uint8_t l = it->pos[1];
+    if (l > it->end - it->pos - 2) return false;
+    *type = it->pos[0];
+    *len = l;
+    *data = it->pos + 2;
+    it->pos += l + 2;
+    return true;
+}
+
+const char *ble_continuity_type_name(uint8_t type) {
+    switch (type) {
+        case 0x02: return "iBeacon";
+        case 0x03: return "AirPrint";
+        case 0x05: return "AirDrop";
+        case 0x06: return "HomeKit";
+        case 0x07: return "Proximity Pairing";
+        case 0x08: return "Hey Siri";
+        case 0x09: return "AirPlay Target";
+        case 0x0a: return "AirPlay Source";
+        case 0x0b: return "Magic Switch";
+        case 0x0c: return "Handoff";
+        case 0x0d: return "Tethering Target";
+        case 0x0e: return "Tethering Source";
+        case 0x0f: return "Nearby Action";
+        case 0x10: return "Nearby Info";
+        case 0x12: return "Find My";
+        default: return NULL;
+    }
+}
+
+const char *ble_ad_type_name(uint8_t type) {
+    switch (type) {
+        case BLE_AD_FLAGS: return "Flags";
+        case BLE_AD_UUID16_INCOMPLETE:
+        case BLE_AD_UUID16_COMPLETE: return "16-bit UUIDs";
+        case BLE_AD_UUID32_INCOMPLETE:
+        case BLE_AD_UUID32_COMPLETE: return "32-bit UUIDs";
+        case BLE_AD_UUID128_INCOMPLETE:
+        case BLE_AD_UUID128_COMPLETE: return "128-bit UUIDs";
+        case BLE_AD_NAME_SHORT: return "Short name";
+        case BLE_AD_NAME_COMPLETE: return "Name";
+        case BLE_AD_TX_POWER: return "TX power";
+        case BLE_AD_SERVICE_DATA16:
+        case BLE_AD_SERVICE_DATA32:
+        case BLE_AD_SERVICE_DATA128: return "Service data";
+        case BLE_AD_APPEARANCE: return "Appearance";
+        case BLE_AD_MANUFACTURER: return "Manufacturer data";
+        default: return NULL;
+    }
+}
@@ -0,0 +1,201 @@
+// components/bluetooth_module/ble_devices.c
+#include "ble_devices.h"
+#include <string.h>
+#include "esp_gap_ble_api.h"
+#include "sdkconfig.h"
+
+#define POOL_SIZE           CONFIG_BT_DEVICE_TABLE_SIZE
+// Load factor stays at or below one half, so probe runs are short and
+// every probe loop reaches an empty slot
+#define INDEX_SLOTS         (2 * POOL_SIZE)
+#define MAX_AGE_MS          (CONFIG_BT_DEVICE_MAX_AGE * 1000u)
+#define EXPIRE_STEP         2       // Aged devices dropped per update
+
+#define NONE                0xffff
+#define RSSI_ALPHA          0.125f  // Weight of a new RSSI sample
+#define INTERVAL_SHIFT      3       // Interval EWMA weight 1/8
+// Longer gaps are missed reports or a device coming back, not its interval
+#define INTERVAL_MAX_MS     10240
+
+typedef struct {
+    ble_device_t dev;
+    uint16_t prev;              // Towards more recently seen
+    uint16_t next;              // Towards less recently seen
+} record_t;
+
+static record_t pool[POOL_SIZE];
+static uint16_t index_slots[INDEX_SLOTS];   // Pool position, NONE when empty
+static uint16_t lru_head = NONE;            // Most recently seen
+static uint16_t lru_tail = NONE;
+static uint16_t free_head = NONE;           // Unused records, linked by next
+static ble_devices_stats_t stats;
+
+_Static_assert(POOL_SIZE < NONE, "Pool positions must fit in 16 bits");
+
+// FNV-1a; random addresses are uniform but public ones share their OUI
+static size_t home_slot(const uint8_t *addr) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 6; i++) {
+        h = (h ^ addr[i]) * 16777619u;
+    }
+    return h % INDEX_SLOTS;
+}
+
+static size_t find_slot(const uint8_t *addr) {
+    size_t i = home_slot(addr);
+    while (index_slots[i] != NONE) {
+        if (memcmp(pool[index_slots[i]].dev.addr, addr, 6) == 0) return i;
+        i = (i + 1) % INDEX_SLOTS;
+    }
+    return i;
+}
+
+static void lru_unlink(uint16_t r) {
+    if (pool[r].prev != NONE) pool[pool[r].prev].next = pool[r].next;
+    else lru_head = pool[r].next;
+    if (pool[r].next != NONE) pool[pool[r].next].prev = pool[r].prev;
+    else lru_tail = pool[r].prev;
+}
+
+static void lru_push_front(uint16_t r) {
+    pool[r].prev = NONE;
+    pool[r].next = lru_head;
+    if (lru_head != NONE) pool[lru_head].prev = r;
+    lru_head = r;
+    if (lru_tail == NONE) lru_tail = r;
+}
+
+// Delete by shifting later members of the probe run back, so the index
+// never accumulates tombstones
+static void index_remove(size_t i) {
+    size_t j = i;
+    while (1) {
+        j = (j + 1) % INDEX_SLOTS;
+        if (index_slots[j] == NONE) break;
+        size_t k = home_slot(pool[index_slots[j]].dev.addr);
+        // Leave the entry if its home lies cyclically in (i, j]
+        bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if (stays) continue;
+        index_slots[i] = index_slots[j];
+        i = j;
+    }
+    index_slots[i] = NONE;
+}
+
+static void remove_record(uint16_t r) {
+    index_remove(find_slot(pool[r].dev.addr));
+    lru_unlink(r);
+    pool[r].next = free_head;
+    free_head = r;
+    stats.devices--;
+}
+
+static bool too_old(uint16_t r, uint32_t now_ms) {
+    return now_ms - pool[r].dev.last_seen_ms > MAX_AGE_MS;
+}
+
+// The LRU tail is the longest silent device, so aging only looks there
+static void expire(uint32_t now_ms, size_t limit) {
+    while (limit-- > 0 && lru_tail != NONE && too_old(lru_tail, now_ms)) {
+        remove_record(lru_tail);
+        stats.expired++;
+    }
+}
+
+void ble_devices_reset(void) {
+    memset(index_slots, 0xff, sizeof(index_slots));
+    for (uint16_t r = 0; r < POOL_SIZE; r++) {
+        pool[r].next = r + 1 < POOL_SIZE ? r + 1 : NONE;
+    }
+    free_head = 0;
+    lru_head = lru_tail = NONE;
+    memset(&stats, 0, sizeof(stats));
+}
+
+static void track(ble_device_t *dev, int8_t rssi, uint8_t evt_type, uint32_t now_ms) {
+    // Incremental exponentially weighted mean and variance
+    float diff = rssi - dev->rssi_mean;
+    dev->rssi_mean += RSSI_ALPHA * diff;
+    dev->rssi_var = (1.0f - RSSI_ALPHA) * (dev->rssi_var + RSSI_ALPHA * diff * diff);
+    dev->rssi = rssi;
+
+    // A scan response trails its advertisement by a millisecond or two,
+    // which is no interval
+    uint32_t gap = now_ms - dev->last_seen_ms;
+    if (evt_type != ESP_BLE_EVT_SCAN_RSP && gap > 0 && gap <= INTERVAL_MAX_MS) {
+        if (dev->interval_ms == 0) {
+            dev->interval_ms = gap;
+        } else {
+            dev->interval_ms += ((int32_t)gap - (int32_t)dev->interval_ms) >> INTERVAL_SHIFT;
+        }
+    }
+    dev->last_seen_ms = now_ms;
+    dev->reports++;
+}
+
+ble_device_t *ble_devices_update(const uint8_t addr[6], uint8_t addr_type, int8_t rssi,
+                                 uint8_t evt_type, uint32_t now_ms, bool *is_new) {
+    expire(now_ms, EXPIRE_STEP);
+
+    size_t slot = find_slot(addr);
+    uint16_t r = index_slots[slot];
+    *is_new = r == NONE;
+    if (!*is_new) {
+        lru_unlink(r);
+        lru_push_front(r);
+        pool[r].dev.addr_type = addr_type;
+        track(&pool[r].dev, rssi, evt_type, now_ms);
+        return &pool[r].dev;
+    }
+
+    if (free_head == NONE) {
+        // Full: the least recently seen device makes room
+        remove_record(lru_tail);
+        stats.evicted++;
+        slot = find_slot(addr);
+    }
+    r = free_head;
+    free_head = pool[r].next;
+
+    ble_device_t *dev = &pool[r].dev;
+    memset(dev, 0, sizeof(*dev));
+    memcpy(dev->addr, addr, 6);
+    dev->addr_type = addr_type;
+    dev->rssi = rssi;
+    dev->rssi_mean = rssi;
+    dev->first_seen_ms = dev->last_seen_ms = now_ms;
+    dev->reports = 1;
+
+    index_slots[slot] = r;
+    lru_push_front(r);
+    stats.devices++;
+    stats.added++;
+    return dev;
+}
+
+ble_device_t *ble_devices_find(const uint8_t addr[6]) {
+    uint16_t r = index_slots[find_slot(addr)];
+    return r == NONE ? NULL : &pool[r].dev;
+}
+
+void ble_devices_set_name(ble_device_t *dev, const char *name, size_t len) {
+    if (len > BLE_DEVICE_NAME_MAX) len = BLE_DEVICE_NAME_MAX;
+    memcpy(dev->name, name, len);
+    dev->name[len] = '\0';
+}
+
+void ble_devices_expire(uint32_t now_ms) {
+    expire(now_ms, POOL_SIZE);
+}
+
+size_t ble_devices_list(ble_device_t *out, size_t max) {
+    size_t n = 0;
+    for (uint16_t r = lru_head; r != NONE && n < max; r = pool[r].next) {
+        out[n++] = pool[r].dev;
+    }
+    return n;
+}
+
+void ble_devices_get_stats(ble_devices_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,86 @@
+// components/bluetooth_module/ble_reports.c
+#include "ble_reports.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+_Static_assert((BLE_REPORTS_CAPACITY & (BLE_REPORTS_CAPACITY - 1)) == 0,
+               "BLE_REPORTS_CAPACITY must be a power of two");
+
+static ble_report_t ring[BLE_REPORTS_CAPACITY];
+static atomic_uint head;        // Next slot to fill; written by the producer
+static atomic_uint tail;        // Next slot to drain; written by the consumer
+
+// Each counter has a single writer; readers may see them a little stale
+static atomic_uint received;
+static atomic_uint dropped;
+static atomic_uint processed;
+static atomic_uint high_water;
+
+// Rates, maintained by the consumer
+static uint32_t window_start_ms;
+static uint32_t window_base[3];
+static uint32_t rates[3];
+
+ble_report_t *ble_reports_reserve(void) {
+    unsigned h = atomic_load_explicit(&head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&tail, memory_order_acquire);
+    atomic_store_explicit(&received, atomic_load_explicit(&received, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (h - t >= BLE_REPORTS_CAPACITY) {
+        atomic_store_explicit(&dropped, atomic_load_explicit(&dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return NULL;
+    }
+    return &ring[h & (BLE_REPORTS_CAPACITY - 1)];
+}
+
+void ble_reports_commit(void) {
+    unsigned h = atomic_load_explicit(&head, memory_order_relaxed) + 1;
+    // Publishes the slot contents to the consumer
+    atomic_store_explicit(&head, h, memory_order_release);
+
+    unsigned waiting = h - atomic_load_explicit(&tail, memory_order_relaxed);
+    if (waiting > atomic_load_explicit(&high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&high_water, waiting, memory_order_relaxed);
+    }
+}
+
+const ble_report_t *ble_reports_peek(void) {
+    unsigned t = atomic_load_explicit(&tail, memory_order_relaxed);
+    if (t == atomic_load_explicit(&head, memory_order_acquire)) return NULL;
+    return &ring[t & (BLE_REPORTS_CAPACITY - 1)];
+}
+
+void ble_reports_release(void) {
+    unsigned t = atomic_load_explicit(&tail, memory_order_relaxed);
+    // The slot may be refilled once the producer sees the new tail
+    atomic_store_explicit(&tail, t + 1, memory_order_release);
+    atomic_store_explicit(&processed, atomic_load_explicit(&processed, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+void ble_reports_tick(uint32_t now_ms) {
+    uint32_t elapsed = now_ms - window_start_ms;
+    if (elapsed < 1000) return;
+
+    uint32_t now[3] = {
+        atomic_load_explicit(&received, memory_order_relaxed),
+        atomic_load_explicit(&dropped, memory_order_relaxed),
+        atomic_load_explicit(&processed, memory_order_relaxed),
+    };
+    for (int i = 0; i < 3; i++) {
+        rates[i] = (uint64_t)(now[i] - window_base[i]) * 1000 / elapsed;
+        window_base[i] = now[i];
+    }
+    window_start_ms = now_ms;
+}
+
+void ble_reports_get_stats(ble_reports_stats_t *stats) {
+    stats->received = atomic_load_explicit(&received, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&dropped, memory_order_relaxed);
+    stats->processed = atomic_load_explicit(&processed, memory_order_relaxed);
+    stats->received_per_s = rates[0];
+    stats->dropped_per_s = rates[1];
+    stats->processed_per_s = rates[2];
+    stats->high_water = atomic_load_explicit(&high_water, memory_order_relaxed);
+}
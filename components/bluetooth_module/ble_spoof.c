@@ -0,0 +1,223 @@
+// components/bluetooth_module/ble_spoof.c
+#include "ble_spoof.h"
+#include <math.h>
+
+#define ALPHA               0.0625f // Weight of a new sample
+#define FADE_WEIGHT         0.01f   // A population this rare is gone
+#define MIN_SAMPLES         32      // Before any verdict
+#define MIN_WEIGHT          0.2f    // Each population's share of a clone
+// One device drifting (walking away, changing mode) switches population
+// rarely; two interleaved ones switch on a large share of reports
+#define MIN_SWITCH_RATE     0.25f
+
+#define EVIDENCE_FLAG       16      // Clone reports in excess to flag
+#define EVIDENCE_MAX        64
+
+#define RSSI_SPLIT_DB       8.0f    // A sample this far off seeds a second level
+// Separation over summed spreads; 2-means cutting one noisy level in two
+// scores about 1.3
+#define RSSI_MIN_SEPARATION 2.0f
+
+#define ADV_DELAY_MS        10      // Random delay added to every advertising event
+#define MIN_INTERVAL_MS     20      // Shortest legal advertising interval
+#define MAX_MISSED          7       // Consecutive missed reports still folded
+#define INTERVAL_MAX_MS     10240   // Longer gaps are silence, not an interval
+#define HIST_FIRST_MS       MIN_INTERVAL_MS     // Lower edge of bin 0
+// Two adjacent bins holding this share mean one interval, whatever the splits say
+#define HIST_SINGLE_SHARE   0.75f
+
+static const uint8_t CLONE_REASONS = BLE_SPOOF_RSSI | BLE_SPOOF_INTERVAL;
+
+// Assign x to the nearer population, seeding a second one when x lies
+// split or more from the only one
+static void split_update(ble_spoof_split_t *s, float x, float split) {
+    if (s->count == 0) {
+        s->mean[0] = x;
+        s->weight[0] = 1.0f;
+        s->count = 1;
+        return;
+    }
+
+    uint8_t k;
+    if (s->count == 1) {
+        k = fabsf(x - s->mean[0]) < split ? 0 : 1;
+        if (k == 1) {
+            s->mean[1] = x;
+            s->var[1] = s->var[0];
+            s->weight[1] = 0.0f;
+            s->count = 2;
+        }
+    } else {
+        k = fabsf(x - s->mean[0]) <= fabsf(x - s->mean[1]) ? 0 : 1;
+    }
+
+    // Exponentially weighted mean and variance, as in the device table
+    float diff = x - s->mean[k];
+    s->mean[k] += ALPHA * diff;
+    s->var[k] = (1.0f - ALPHA) * (s->var[k] + ALPHA * diff * diff);
+    s->weight[k] += ALPHA * (1.0f - s->weight[k]);
+    s->weight[!k] -= ALPHA * s->weight[!k];
+    s->switch_rate += ALPHA * ((k != s->last) - s->switch_rate);
+    s->last = k;
+
+    // Populations that meet or fade are one again
+    if (s->count == 2 && (fabsf(s->mean[0] - s->mean[1]) < split / 2 ||
+                          s->weight[0] < FADE_WEIGHT || s->weight[1] < FADE_WEIGHT)) {
+        uint8_t keep = s->weight[1] > s->weight[0];
+        s->mean[0] = s->mean[keep];
+        s->var[0] = s->var[keep];
+        s->weight[0] = 1.0f;
+        s->count = 1;
+        s->last = 0;
+    }
+}
+
+// Both populations well represented and taking turns
+static bool interleaved(const ble_spoof_split_t *s) {
+    return s->count == 2 && s->weight[0] >= MIN_WEIGHT && s->weight[1] >= MIN_WEIGHT &&
+           s->switch_rate >= MIN_SWITCH_RATE;
+}
+
+static bool rssi_cloned(const ble_spoof_split_t *s) {
+    if (!interleaved(s)) return false;
+    float separation = fabsf(s->mean[0] - s->mean[1]);
+    return separation >= RSSI_SPLIT_DB &&
+           separation >= RSSI_MIN_SEPARATION * (sqrtf(s->var[0]) + sqrtf(s->var[1]));
+}
+
+// 20 ms * 2^(bin / 2): octave from the integer log, half from a sqrt(2) test
+static uint8_t interval_bin(uint32_t gap_ms) {
+    if (gap_ms < HIST_FIRST_MS) return 0;
+    uint32_t octave = 31 - __builtin_clz(gap_ms / HIST_FIRST_MS);
+    // gap >= 20 * 2^octave * 99/70 (sqrt 2)
+    uint32_t half = gap_ms * 70 >= (uint32_t)(HIST_FIRST_MS * 99) << octave;
+    uint32_t bin = 2 * octave + half;
+    return bin < BLE_SPOOF_INTERVAL_BINS ? bin : BLE_SPOOF_INTERVAL_BINS - 1;
+}
+
+static void hist_add(uint8_t *hist, uint8_t bin) {
+    // Halving keeps the counts in a byte and ages old gaps out
+    if (hist[bin] == UINT8_MAX) {
+        for (int i = 0; i < BLE_SPOOF_INTERVAL_BINS; i++) hist[i] /= 2;
+    }
+    hist[bin]++;
+}
+
+// Most gaps within two adjacent bins: one advertiser rarely missed
+static bool hist_single(const uint8_t *hist) {
+    uint32_t total = 0, best = 0;
+    for (int i = 0; i < BLE_SPOOF_INTERVAL_BINS; i++) {
+        total += hist[i];
+        uint32_t pair = hist[i] + (i + 1 < BLE_SPOOF_INTERVAL_BINS ? hist[i + 1] : 0);
+        if (pair > best) best = pair;
+    }
+    return best >= HIST_SINGLE_SHARE * total;
+}
+
+// k whole intervals of base, within the advertising delays they add.
+// Bases below the shortest legal interval would divide anything, and the
+// tolerance is capped so short bases do not either.
+static bool multiple_of(float gap, float base, float *k) {
+    if (base < MIN_INTERVAL_MS) return false;
+    *k = roundf(gap / base);
+    float tolerance = fminf(*k * ADV_DELAY_MS, base / 4);
+    return *k >= 2 && *k <= MAX_MISSED + 1 && fabsf(gap - *k * base) <= tolerance;
+}
+
+// A missed report makes a gap of k intervals; count it as one interval
+// of the shortest population so misses do not look like a second one
+static float fold_gap(ble_spoof_split_t *s, uint32_t gap_ms) {
+    if (s->count == 0) return gap_ms;
+    float base = s->count == 2 ? fminf(s->mean[0], s->mean[1]) : s->mean[0];
+    float k;
+    if (multiple_of(gap_ms, base, &k)) return gap_ms / k;
+    // The populations so far were made of missed reports; start again
+    if (multiple_of(base, gap_ms, &k)) s->count = 0;
+    return gap_ms;
+}
+
+static void interval_update(ble_spoof_model_t *m, uint32_t gap_ms) {
+    if (gap_ms == 0 || gap_ms > INTERVAL_MAX_MS) return;
+    hist_add(m->interval_hist, interval_bin(gap_ms));
+
+    float gap = fold_gap(&m->interval, gap_ms);
+    // Jitter of one advertiser is two advertising delays either way
+    float split = fmaxf(2 * ADV_DELAY_MS, 0.25f * gap);
+    split_update(&m->interval, gap, split);
+}
+
+static bool interval_cloned(const ble_spoof_model_t *m) {
+    return interleaved(&m->interval) && !hist_single(m->interval_hist);
+}
+
+static void payload_update(ble_spoof_model_t *m, uint32_t fingerprint) {
+    if (fingerprint == 0) return;
+    uint8_t k;
+    if (m->fingerprint[0] == 0 || m->fingerprint[0] == fingerprint) {
+        k = 0;
+    } else if (m->fingerprint[1] == fingerprint) {
+        k = 1;
+    } else {
+        // A new payload replaces the one not seen last
+        k = !m->payload_last;
+    }
+    m->fingerprint[k] = fingerprint;
+    m->payload_switch_rate += ALPHA * ((k != m->payload_last) - m->payload_switch_rate);
+    m->payload_last = k;
+}
+
+static uint32_t fnv(uint32_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len-- > 0) {
+        h = (h ^ *p++) * 16777619u;
+    }
+    return h;
+}
+
+uint32_t ble_spoof_fingerprint(const ble_adv_info_t *info) {
+    uint32_t h = 2166136261u;
+    h = fnv(h, &info->flags, sizeof(info->flags));
+    h = fnv(h, info->name ? info->name : "", info->name_len);
+    if (info->has_tx_power) h = fnv(h, &info->tx_power, 1);
+    if (info->uuid16) h = fnv(h, info->uuid16, 2 * info->num_uuid16);
+    if (info->uuid32) h = fnv(h, info->uuid32, 4 * info->num_uuid32);
+    if (info->uuid128) h = fnv(h, info->uuid128, 16 * info->num_uuid128);
+    // Owners only: manufacturer and service data often carry counters
+    if (info->mfr_data) h = fnv(h, &info->company_id, sizeof(info->company_id));
+    if (info->svc_data) h = fnv(h, &info->svc_uuid16, sizeof(info->svc_uuid16));
+    return h ? h : 1;
+}
+
+uint8_t ble_spoof_update(ble_spoof_model_t *m, int8_t rssi, uint32_t gap_ms, uint32_t fingerprint) {
+    split_update(&m->rssi, rssi, RSSI_SPLIT_DB);
+    interval_update(m, gap_ms);
+    payload_update(m, fingerprint);
+    if (m->samples < UINT16_MAX) m->samples++;
+    if (m->samples < MIN_SAMPLES) return 0;
+
+    uint8_t reasons = 0;
+    if (rssi_cloned(&m->rssi)) reasons |= BLE_SPOOF_RSSI;
+    if (interval_cloned(m)) reasons |= BLE_SPOOF_INTERVAL;
+    if (m->payload_switch_rate >= MIN_SWITCH_RATE) reasons |= BLE_SPOOF_PAYLOAD;
+
+    // Leaky bucket, so a verdict needs a run of reports to set or clear
+    if (reasons & CLONE_REASONS) {
+        if (m->evidence < EVIDENCE_MAX) m->evidence++;
+        if (m->evidence >= EVIDENCE_FLAG) m->flagged = true;
+    } else if (m->evidence > 0 && --m->evidence == 0) {
+        m->flagged = false;
+    }
+    return reasons;
+}
+
+uint32_t ble_spoof_typical_interval(const ble_spoof_model_t *m) {
+    int best = -1;
+    for (int i = 0; i < BLE_SPOOF_INTERVAL_BINS; i++) {
+        if (m->interval_hist[i] > 0 && (best < 0 || m->interval_hist[i] > m->interval_hist[best])) {
+            best = i;
+        }
+    }
+    if (best < 0) return 0;
+    // Geometric centre: 20 ms * 2^((bin + 0.5) / 2)
+    return HIST_FIRST_MS * exp2f((best + 0.5f) / 2);
+}
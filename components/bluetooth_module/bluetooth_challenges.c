@@ -1,10 +1,19 @@
 // components/bluetooth_module/bluetooth_challenges.c
 #include "bluetooth_challenges.h"
 #include "esp_log.h"
+#include "ble_adv.h"
+#include "ble_devices.h"
+#include "ble_reports.h"
+#include "ble_spoof.h"
+#include "oui_lookup.h"
+#include "event_stream.h"
 #include "nvs_flash.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "bluetooth_challenges";
@@ -13,9 +22,6 @@ static const char *TAG = "bluetooth_challenges";
 static bluetooth_challenge_type_t active_challenge = -1;
 static TaskHandle_t challenge_task_handle = NULL;
 
-// Queue for BLE events
-static QueueHandle_t ble_evt_queue = NULL;
-
 // GATT profile for vulnerable service demonstration
 static uint16_t vulnerable_service_handle;
 static uint16_t vulnerable_char_handle;
@@ -23,57 +29,286 @@ static uint16_t vulnerable_char_handle;
 #define VULNERABLE_SERVICE_UUID      0xFF00
 #define VULNERABLE_CHARACTERISTIC_UUID 0xFF01
 
-// Simulated device database for spoofing detection
-typedef struct {
-    esp_bd_addr_t addr;
-    char name[32];
-    int8_t rssi;
-    uint32_t first_seen;
-    uint32_t last_seen;
-} known_device_t;
+#define REPORT_TASK_STACK       4096
+#define REPORT_TASK_PRIORITY    4
+#define REPORT_STATS_PERIOD_MS  10000
+
+static TaskHandle_t report_task_handle = NULL;
+static uint32_t clones_flagged;
+
+_Static_assert(BLE_REPORT_DATA_MAX == ESP_BLE_ADV_DATA_LEN_MAX + ESP_BLE_SCAN_RSP_DATA_LEN_MAX,
+               "A report must hold the advertising data and scan response");
+
+// Add the report to the device table, picking up an advertised name
+static ble_device_t *track_device(const ble_report_t *report, const ble_adv_info_t *info,
+                                  bool *is_new) {
+    ble_device_t *dev = ble_devices_update(report->addr, report->addr_type, report->rssi,
+                                           report->evt_type, report->timestamp_ms, is_new);
+    if (info->name != NULL) {
+        ble_devices_set_name(dev, info->name, info->name_len);
+    }
+    return dev;
+}
+
+// Short description of a recognised beacon or phone payload, "" if none
+static void describe_adv(const ble_adv_info_t *info, char *out, size_t size) {
+    ble_ibeacon_t beacon;
+    ble_eddystone_t eddystone;
+    ble_continuity_iter_t it;
+
+    out[0] = '\0';
+    if (ble_adv_ibeacon(info, &beacon)) {
+        snprintf(out, size, "iBeacon %u/%u", beacon.major, beacon.minor);
+    } else if (ble_adv_eddystone(info, &eddystone)) {
+        switch (eddystone.frame) {
+            case BLE_EDDYSTONE_UID: snprintf(out, size, "Eddystone-UID"); break;
+            case BLE_EDDYSTONE_URL: {
+                int n = snprintf(out, size, "Eddystone-URL ");
+                if (n > 0 && (size_t)n < size) ble_eddystone_url(&eddystone, out + n, size - n);
+                break;
+            }
+            case BLE_EDDYSTONE_TLM: snprintf(out, size, "Eddystone-TLM"); break;
+            case BLE_EDDYSTONE_EID: snprintf(out, size, "Eddystone-EID"); break;
+        }
+    } else if (ble_continuity_iter_init(&it, info)) {
+        // The first message type says what kind of Apple device it is
+        uint8_t type, len;
+        const uint8_t *data;
+        const char *name = NULL;
+        if (ble_continuity_next(&it, &type, &data, &len)) name = ble_continuity_type_name(type);
+        snprintf(out, size, "Apple %s", name ? name : "Continuity");
+    }
+}
+
+// Decoded dump of a report for the sniffing challenge
+static void log_adv(const ble_report_t *report, const ble_adv_info_t *info, bool malformed) {
+    ESP_LOGI(TAG, "Advertisement from " ESP_BD_ADDR_STR ", %d dBm, %u AD structures%s",
+             ESP_BD_ADDR_HEX(report->addr), report->rssi, info->num_ad,
+             malformed ? " (malformed)" : "");
+
+    // Structure list, with raw bytes only for types the decoder does not know
+    const uint8_t *parts[2] = {report->data, report->data + report->adv_len};
+    uint8_t part_lens[2] = {report->adv_len, report->rsp_len};
+    for (int i = 0; i < 2; i++) {
+        ble_ad_iter_t it;
+        ble_ad_t ad;
+        ble_ad_iter_init(&it, parts[i], part_lens[i]);
+        while (ble_ad_next(&it, &ad)) {
+            const char *name = ble_ad_type_name(ad.type);
+            if (name != NULL) {
+                ESP_LOGI(TAG, "  %s%s (%u bytes)", i ? "Scan response: " : "", name, ad.len);
+            } else {
+                ESP_LOGI(TAG, "  %sType 0x%02x (%u bytes)", i ? "Scan response: " : "", ad.type, ad.len);
+                esp_log_buffer_hex(TAG, ad.data, ad.len);
+            }
+        }
+    }
+
+    if (info->name != NULL) {
+        ESP_LOGI(TAG, "  Name: %.*s%s", info->name_len, info->name,
+                 info->name_complete ? "" : " (shortened)");
+    }
+    if (info->has_tx_power) ESP_LOGI(TAG, "  TX power: %d dBm", info->tx_power);
+    for (uint8_t i = 0; i < info->num_uuid16; i++) {
+        ESP_LOGI(TAG, "  Service: 0x%04x", info->uuid16[2 * i] | info->uuid16[2 * i + 1] << 8);
+    }
+    if (info->mfr_data != NULL) {
+        ESP_LOGI(TAG, "  Manufacturer 0x%04x, %u bytes", info->company_id, info->mfr_len);
+    }
+
+    ble_ibeacon_t beacon;
+    ble_eddystone_t eddystone;
+    ble_continuity_iter_t it;
+    if (ble_adv_ibeacon(info, &beacon)) {
+        const uint8_t *u = beacon.uuid;
+        ESP_LOGI(TAG, "  iBeacon %02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x "
+                 "major %u minor %u, %d dBm at 1 m",
+                 u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7], u[8], u[9], u[10], u[11],
+                 u[12], u[13], u[14], u[15], beacon.major, beacon.minor, beacon.measured_power);
+    } else if (ble_adv_eddystone(info, &eddystone)) {
+        switch (eddystone.frame) {
+            case BLE_EDDYSTONE_UID: {
+                const uint8_t *ns = eddystone.uid.namespace_id;
+                const uint8_t *in = eddystone.uid.instance_id;
+                ESP_LOGI(TAG, "  Eddystone-UID %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x/"
+                         "%02x%02x%02x%02x%02x%02x, %d dBm at 0 m",
+                         ns[0], ns[1], ns[2], ns[3], ns[4], ns[5], ns[6], ns[7], ns[8], ns[9],
+                         in[0], in[1], in[2], in[3], in[4], in[5], eddystone.tx_power);
+                break;
+            }
+            case BLE_EDDYSTONE_URL: {
+                char url[64];
+                ble_eddystone_url(&eddystone, url, sizeof(url));
+                ESP_LOGI(TAG, "  Eddystone-URL %s, %d dBm at 0 m", url, eddystone.tx_power);
+                break;
+            }
+            case BLE_EDDYSTONE_TLM: {
+                int temp = abs(eddystone.tlm.temp_q8);
+                ESP_LOGI(TAG, "  Eddystone-TLM %u mV, %s%d.%02d C, %" PRIu32 " advertisements, up %" PRIu32 " s",
+                         eddystone.tlm.battery_mv, eddystone.tlm.temp_q8 < 0 ? "-" : "",
+                         temp / 256, temp % 256 * 100 / 256,
+                         eddystone.tlm.adv_count, eddystone.tlm.uptime_ds / 10);
+                break;
+            }
+            case BLE_EDDYSTONE_EID:
+                ESP_LOGI(TAG, "  Eddystone-EID, %d dBm at 0 m", eddystone.tx_power);
+                break;
+        }
+    } else if (ble_continuity_iter_init(&it, info)) {
+        uint8_t type, len;
+        const uint8_t *data;
+        while (ble_continuity_next(&it, &type, &data, &len)) {
+            const char *name = ble_continuity_type_name(type);
+            if (name != NULL) {
+                ESP_LOGI(TAG, "  Apple %s (%u bytes)", name, len);
+            } else {
+                ESP_LOGI(TAG, "  Apple type 0x%02x (%u bytes)", type, len);
+            }
+        }
+    }
+}
+
+// All per-report work, on the report task
+static void process_report(const ble_report_t *report) {
+    bool is_new;
+    // Parsed in place; info points into the report until it is released
+    ble_adv_info_t info;
+    ble_adv_info_init(&info);
+    bool malformed = ble_adv_parse(&info, report->data, report->adv_len) != ESP_OK;
+    malformed |= ble_adv_parse(&info, report->data + report->adv_len, report->rsp_len) != ESP_OK;
+
+    // Gap since the last report, before this one is folded in
+    ble_device_t *known = ble_devices_find(report->addr);
+    uint32_t gap_ms = known ? report->timestamp_ms - known->last_seen_ms : 0;
+    ble_device_t *dev = track_device(report, &info, &is_new);
+
+    // A scan response follows its advertisement within milliseconds and
+    // carries other data, so it only adds an RSSI sample
+    bool scan_rsp = report->evt_type == ESP_BLE_EVT_SCAN_RSP;
+    bool was_flagged = dev->spoof.flagged;
+    uint8_t reasons = ble_spoof_update(&dev->spoof, report->rssi, scan_rsp ? 0 : gap_ms,
+                                       scan_rsp ? 0 : ble_spoof_fingerprint(&info));
+
+    // Process scan results based on active challenge
+    switch (active_challenge) {
+        case BT_CHALLENGE_SCANNING: {
+            // Reports repeat every advertising interval; log each device once
+            if (!is_new) break;
+
+            // Only public addresses carry an IEEE OUI
+            char vendor[48] = "Random address";
+            if (report->addr_type == BLE_ADDR_TYPE_PUBLIC) {
+                oui_lookup_vendor(report->addr, vendor, sizeof(vendor));
+            }
+            char kind[48];
+            describe_adv(&info, kind, sizeof(kind));
+            ESP_LOGI(TAG, "Found device: " ESP_BD_ADDR_STR " (%s) %s %s",
+                    ESP_BD_ADDR_HEX(report->addr), vendor, dev->name, kind);
+            ESP_LOGI(TAG, "RSSI: %d", report->rssi);
+
+            // Names and Eddystone URLs come off the air. Escaped sizes keep
+            // the worst case within the payload limit
+            char vendor_esc[17], kind_esc[21], name_esc[12];
+            event_json_escape(vendor_esc, sizeof(vendor_esc), vendor, sizeof(vendor));
+            event_json_escape(kind_esc, sizeof(kind_esc), kind, sizeof(kind));
+            event_json_escape(name_esc, sizeof(name_esc), dev->name, sizeof(dev->name));
+
+            char json[EVENT_STREAM_PAYLOAD_MAX];
+            int n = snprintf(json, sizeof(json), "{\"addr\":\"" ESP_BD_ADDR_STR "\",\"rssi\":%d,\"vendor\":\"%s\",\"kind\":\"%s\",\"name\":\"%s\"}",
+                             ESP_BD_ADDR_HEX(report->addr), report->rssi, vendor_esc, kind_esc, name_esc);
+            if (n > 0 && n < (int)sizeof(json)) {
+                event_stream_publish(EVENT_SRC_BLUETOOTH, "device", json, n);
+            }
+            break;
+        }
+
+        case BT_CHALLENGE_SNIFFING:
+            log_adv(report, &info, malformed);
+            break;
+
+        case BT_CHALLENGE_SPOOFING: {
+            // Report each device once per time it starts looking cloned
+            if (!dev->spoof.flagged || was_flagged) break;
+            clones_flagged++;
+
+            const ble_spoof_model_t *m = &dev->spoof;
+            ESP_LOGW(TAG, "Possible cloned address " ESP_BD_ADDR_STR " (%s%s%s)",
+                     ESP_BD_ADDR_HEX(report->addr), reasons & BLE_SPOOF_RSSI ? " rssi" : "",
+                     reasons & BLE_SPOOF_INTERVAL ? " interval" : "",
+                     reasons & BLE_SPOOF_PAYLOAD ? " payload" : "");
+            if (reasons & BLE_SPOOF_RSSI) {
+                ESP_LOGW(TAG, "  RSSI levels %.0f and %.0f dBm", m->rssi.mean[0], m->rssi.mean[1]);
+            }
+            if (reasons & BLE_SPOOF_INTERVAL) {
+                ESP_LOGW(TAG, "  Report gaps %.0f and %.0f ms, typical interval %" PRIu32 " ms",
+                         m->interval.mean[0], m->interval.mean[1], ble_spoof_typical_interval(m));
+            }
+
+            char json[EVENT_STREAM_PAYLOAD_MAX];
+            int n = snprintf(json, sizeof(json), "{\"addr\":\"" ESP_BD_ADDR_STR "\",\"reasons\":%u,\"rssi\":[%d,%d],\"gaps\":[%" PRIu32 ",%" PRIu32 "]}",
+                             ESP_BD_ADDR_HEX(report->addr), reasons,
+                             (int)m->rssi.mean[0], (int)m->rssi.mean[m->rssi.count > 1],
+                             (uint32_t)m->interval.mean[0], (uint32_t)m->interval.mean[m->interval.count > 1]);
+            event_stream_publish(EVENT_SRC_BLUETOOTH, "clone", json, n);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Drains the report ring; woken by the GAP callback
+static void report_task(void *pvParameters) {
+    uint32_t last_log_ms = 0;
+    uint32_t last_received = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
 
-#define MAX_KNOWN_DEVICES 10
-static known_device_t known_devices[MAX_KNOWN_DEVICES];
-static int num_known_devices = 0;
+        const ble_report_t *report;
+        while ((report = ble_reports_peek()) != NULL) {
+            process_report(report);
+            ble_reports_release();
+        }
 
-// GAP event handler
+        uint32_t now_ms = esp_timer_get_time() / 1000;
+        ble_reports_tick(now_ms);
+        ble_devices_expire(now_ms);
+
+        ble_reports_stats_t stats;
+        ble_reports_get_stats(&stats);
+        if (now_ms - last_log_ms >= REPORT_STATS_PERIOD_MS && stats.received != last_received) {
+            ESP_LOGI(TAG, "Reports/s: %" PRIu32 " received, %" PRIu32 " dropped, %" PRIu32 " processed (queue peak %" PRIu32 ")",
+                     stats.received_per_s, stats.dropped_per_s, stats.processed_per_s, stats.high_water);
+            last_log_ms = now_ms;
+            last_received = stats.received;
+        }
+    }
+}
+
+// GAP event handler. Runs on Bluedroid's BTC task, so scan results are only
+// copied into the report ring; the report task does the rest.
 static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) {
     switch (event) {
-        case ESP_GAP_BLE_SCAN_RESULT_EVT:
-            if (param->scan_rst.search_evt == ESP_GAP_SEARCH_INQ_RES_EVT) {
-                // Process scan results based on active challenge
-                switch (active_challenge) {
-                    case BT_CHALLENGE_SCANNING:
-                        ESP_LOGI(TAG, "Found device: " ESP_BD_ADDR_STR, 
-                                ESP_BD_ADDR_HEX(param->scan_rst.bda));
-                        ESP_LOGI(TAG, "RSSI: %d", param->scan_rst.rssi);
-                        break;
-                        
-                    case BT_CHALLENGE_SNIFFING:
-                        // Analyze advertisement data
-                        if (param->scan_rst.adv_data_len > 0) {
-                            ESP_LOGI(TAG, "Advertisement data:");
-                            esp_log_buffer_hex(TAG, param->scan_rst.ble_adv, 
-                                             param->scan_rst.adv_data_len);
-                        }
-                        break;
-                        
-                    case BT_CHALLENGE_SPOOFING:
-                        // Check for suspicious device patterns
-                        for (int i = 0; i < num_known_devices; i++) {
-                            if (memcmp(known_devices[i].addr, param->scan_rst.bda, 
-                                     ESP_BD_ADDR_LEN) == 0) {
-                                // Check for suspicious RSSI changes
-                                if (abs(known_devices[i].rssi - param->scan_rst.rssi) > 20) {
-                                    ESP_LOGW(TAG, "Suspicious RSSI change detected!");
-                                }
-                                break;
-                            }
-                        }
-                        break;
-                }
-            }
+        case ESP_GAP_BLE_SCAN_RESULT_EVT: {
+            struct ble_scan_result_evt_param *scan = &param->scan_rst;
+            if (scan->search_evt != ESP_GAP_SEARCH_INQ_RES_EVT) break;
+
+            ble_report_t *report = ble_reports_reserve();
+            if (report == NULL) break;
+            report->timestamp_ms = esp_timer_get_time() / 1000;
+            memcpy(report->addr, scan->bda, sizeof(report->addr));
+            report->addr_type = scan->ble_addr_type;
+            report->evt_type = scan->ble_evt_type;
+            report->rssi = scan->rssi;
+            report->adv_len = scan->adv_data_len;
+            report->rsp_len = scan->scan_rsp_len;
+            memcpy(report->data, scan->ble_adv, scan->adv_data_len + scan->scan_rsp_len);
+            ble_reports_commit();
+            xTaskNotifyGive(report_task_handle);
             break;
+        }
             
         case ESP_GAP_BLE_AUTH_CMPL_EVT:
             if (active_challenge == BT_CHALLENGE_PAIRING) {
@@ -81,6 +316,9 @@ static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param
                          param->ble_security.auth_cmpl.auth_mode);
             }
             break;
+
+        default:
+            break;
     }
 }
 
@@ -105,9 +343,15 @@ static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_
     }
 }
 
-// Task to handle scanning challenge
+// Task to handle the challenges that scan: scanning, sniffing and spoofing
 static void scanning_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Starting BLE Scanning Challenge");
+    static const char *const names[] = {
+        [BT_CHALLENGE_SCANNING] = "Scanning",
+        [BT_CHALLENGE_SNIFFING] = "Sniffing",
+        [BT_CHALLENGE_SPOOFING] = "Spoofing Detection",
+    };
+    bluetooth_challenge_type_t challenge = (bluetooth_challenge_type_t)(intptr_t)pvParameters;
+    ESP_LOGI(TAG, "Starting BLE %s Challenge", names[challenge]);
     
     // Configure scan parameters
     esp_ble_scan_params_t scan_params = {
@@ -122,7 +366,7 @@ static void scanning_task(void *pvParameters) {
     ESP_ERROR_CHECK(esp_ble_gap_set_scan_params(&scan_params));
     ESP_ERROR_CHECK(esp_ble_gap_start_scanning(0));
     
-    while (active_challenge == BT_CHALLENGE_SCANNING) {
+    while (active_challenge == challenge) {
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
     
@@ -171,13 +415,17 @@ esp_err_t bluetooth_challenges_init(void) {
     ESP_ERROR_CHECK(esp_bluedroid_init());
     ESP_ERROR_CHECK(esp_bluedroid_enable());
     
+    // The report task must exist before scan results can arrive
+    ble_devices_reset();
+    if (xTaskCreate(report_task, "ble_reports", REPORT_TASK_STACK, NULL,
+                    REPORT_TASK_PRIORITY, &report_task_handle) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
     // Register callbacks
     ESP_ERROR_CHECK(esp_ble_gap_register_callback(gap_event_handler));
     ESP_ERROR_CHECK(esp_ble_gatts_register_callback(gatts_event_handler));
     
-    // Create event queue
-    ble_evt_queue = xQueueCreate(10, sizeof(esp_gap_ble_cb_event_t));
-    
     return ESP_OK;
 }
 
@@ -191,7 +439,9 @@ esp_err_t start_bluetooth_challenge(bluetooth_challenge_type_t type) {
     
     switch (type) {
         case BT_CHALLENGE_SCANNING:
-            xTaskCreate(scanning_task, "scanning_task", 4096, NULL, 5, &challenge_task_handle);
+        case BT_CHALLENGE_SNIFFING:
+        case BT_CHALLENGE_SPOOFING:
+            xTaskCreate(scanning_task, "scanning_task", 4096, (void *)(intptr_t)type, 5, &challenge_task_handle);
             break;
             
         case BT_CHALLENGE_PAIRING:
@@ -222,4 +472,21 @@ esp_err_t stop_bluetooth_challenge(void) {
     
     ESP_LOGI(TAG, "Stopped Bluetooth challenge");
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+// Scan pipeline counters as a JSON object
+esp_err_t get_bluetooth_challenge_status(void* status_buffer, size_t buffer_size) {
+    ble_reports_stats_t reports;
+    ble_reports_get_stats(&reports);
+    ble_devices_stats_t devices;
+    ble_devices_get_stats(&devices);
+
+    int n = snprintf(status_buffer, buffer_size,
+                     "{\"challenge\":%d,\"devices\":%" PRIu32 ",\"received\":%" PRIu32 ",\"dropped\":%" PRIu32
+                     ",\"processed\":%" PRIu32 ",\"received_per_s\":%" PRIu32 ",\"dropped_per_s\":%" PRIu32
+                     ",\"processed_per_s\":%" PRIu32 ",\"clones\":%" PRIu32 "}",
+                     (int)active_challenge, devices.devices, reports.received, reports.dropped,
+                     reports.processed, reports.received_per_s, reports.dropped_per_s,
+                     reports.processed_per_s, clones_flagged);
+    return n >= 0 && (size_t)n < buffer_size ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
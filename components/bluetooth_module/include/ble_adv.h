@@ -0,0 +1,148 @@
+// components/bluetooth_module/include/ble_adv.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Allocation-free parsing of BLE advertising data (Core Spec Vol 3 Part C
+// §11, Supplement Part A). Everything points into the caller's report
+// buffer, which must outlive the results; nothing is copied.
+
+// AD types
+#define BLE_AD_FLAGS                0x01
+#define BLE_AD_UUID16_INCOMPLETE    0x02
+#define BLE_AD_UUID16_COMPLETE      0x03
+#define BLE_AD_UUID32_INCOMPLETE    0x04
+#define BLE_AD_UUID32_COMPLETE      0x05
+#define BLE_AD_UUID128_INCOMPLETE   0x06
+#define BLE_AD_UUID128_COMPLETE     0x07
+#define BLE_AD_NAME_SHORT           0x08
+#define BLE_AD_NAME_COMPLETE        0x09
+#define BLE_AD_TX_POWER             0x0a
+#define BLE_AD_SERVICE_DATA16       0x16
+#define BLE_AD_APPEARANCE           0x19
+#define BLE_AD_SERVICE_DATA32       0x20
+#define BLE_AD_SERVICE_DATA128      0x21
+#define BLE_AD_MANUFACTURER         0xff
+
+#define BLE_COMPANY_APPLE           0x004c
+#define BLE_UUID_EDDYSTONE          0xfeaa
+
+// One AD structure
+typedef struct {
+    uint8_t type;
+    uint8_t len;                // Of data, without the type byte
+    const uint8_t *data;
+} ble_ad_t;
+
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool malformed;             // A length ran past the end of the buffer
+} ble_ad_iter_t;
+
+void ble_ad_iter_init(ble_ad_iter_t *it, const uint8_t *data, size_t len);
+
+// Next AD structure; false at the end, at zero padding or on a malformed
+// length (it->malformed set)
+bool ble_ad_next(ble_ad_iter_t *it, ble_ad_t *ad);
+
+// Summary of the common AD types. Lists are little-endian UUIDs as sent.
+typedef struct {
+    int16_t flags;              // -1 if absent
+    const char *name;           // Not terminated; NULL if absent
+    uint8_t name_len;
+    bool name_complete;
+    bool has_tx_power;
+    int8_t tx_power;            // dBm
+    const uint8_t *uuid16;      // 2 bytes each
+    uint8_t num_uuid16;
+    const uint8_t *uuid32;      // 4 bytes each
+    uint8_t num_uuid32;
+    const uint8_t *uuid128;     // 16 bytes each
+    uint8_t num_uuid128;
+    uint16_t company_id;        // Manufacturer data, valid if mfr_data set
+    const uint8_t *mfr_data;    // After the company id
+    uint8_t mfr_len;
+    uint16_t svc_uuid16;        // First 16-bit service data, valid if svc_data set
+    const uint8_t *svc_data;    // After the UUID
+    uint8_t svc_len;
+    uint8_t num_ad;             // AD structures seen
+} ble_adv_info_t;
+
+void ble_adv_info_init(ble_adv_info_t *info);
+
+// Add the AD structures in data to info. Call once for the advertising
+// data and again for the scan response; the first occurrence of a field
+// wins. Returns ESP_ERR_INVALID_SIZE if the data is malformed, keeping
+// what was parsed before the bad structure.
+esp_err_t ble_adv_parse(ble_adv_info_t *info, const uint8_t *data, size_t len);
+
+// Apple iBeacon
+typedef struct {
+    const uint8_t *uuid;        // 16 bytes, big-endian
+    uint16_t major;
+    uint16_t minor;
+    int8_t measured_power;      // RSSI at 1 m
+} ble_ibeacon_t;
+
+bool ble_adv_ibeacon(const ble_adv_info_t *info, ble_ibeacon_t *out);
+
+// Google Eddystone
+typedef enum {
+    BLE_EDDYSTONE_UID = 0x00,
+    BLE_EDDYSTONE_URL = 0x10,
+    BLE_EDDYSTONE_TLM = 0x20,
+    BLE_EDDYSTONE_EID = 0x30,
+} ble_eddystone_frame_t;
+
+typedef struct {
+    uint8_t frame;              // ble_eddystone_frame_t
+    int8_t tx_power;            // UID, URL, EID: dBm at 0 m
+    union {
+        struct {
+            const uint8_t *namespace_id;    // 10 bytes
+            const uint8_t *instance_id;     // 6 bytes
+        } uid;
+        struct {
+            const uint8_t *encoded;         // Scheme byte, then compressed URL
+            uint8_t len;
+        } url;
+        struct {
+            uint16_t battery_mv;            // 0 if not reported
+            int16_t temp_q8;                // Celsius, 8.8 fixed point
+            uint32_t adv_count;
+            uint32_t uptime_ds;             // Tenths of a second
+        } tlm;
+        struct {
+            const uint8_t *eid;             // 8 bytes
+        } eid;
+    };
+} ble_eddystone_t;
+
+bool ble_adv_eddystone(const ble_adv_info_t *info, ble_eddystone_t *out);
+
+// Expand an Eddystone-URL into out (always terminated). Returns the full
+// length, which may exceed size - 1 if out was too small.
+size_t ble_eddystone_url(const ble_eddystone_t *frame, char *out, size_t size);
+
+// Apple Continuity messages: type-length-value records in Apple
+// manufacturer data
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+} ble_continuity_iter_t;
+
+// False if info has no Apple manufacturer data
+bool ble_continuity_iter_init(ble_continuity_iter_t *it, const ble_adv_info_t *info);
+
+bool ble_continuity_next(ble_continuity_iter_t *it, uint8_t *type, const uint8_t **data,
+                         uint8_t *len);
+
+// "Nearby Info", "Find My", ... or NULL for unknown types
+const char *ble_continuity_type_name(uint8_t type);
+
+// Name of an AD type for logs, or NULL for unknown types
+const char *ble_ad_type_name(uint8_t type);
@@ -0,0 +1,62 @@
+// components/bluetooth_module/include/ble_devices.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "ble_spoof.h"
+
+// Table of BLE advertisers keyed by BD address: an open-addressing index
+// over a fixed pool of CONFIG_BT_DEVICE_TABLE_SIZE records, kept in least
+// recently seen order. Devices silent for CONFIG_BT_DEVICE_MAX_AGE seconds
+// are aged out, and a new device takes the least recently seen record when
+// the pool is full, so every report costs O(1) and memory is fixed.
+//
+// Not locked; use it from one task.
+
+#define BLE_DEVICE_NAME_MAX     29      // Longest name a legacy advert can carry
+
+typedef struct {
+    uint8_t addr[6];
+    uint8_t addr_type;          // BLE_ADDR_TYPE_*
+    char name[BLE_DEVICE_NAME_MAX + 1];     // Empty until one is advertised
+    int8_t rssi;                // Latest report
+    float rssi_mean;            // Exponentially weighted, dBm
+    float rssi_var;             // Exponentially weighted, dB^2
+    uint32_t interval_ms;       // Smoothed time between reports, 0 until known
+    uint32_t first_seen_ms;
+    uint32_t last_seen_ms;
+    uint32_t reports;
+    ble_spoof_model_t spoof;    // Zeroed when the device is added
+} ble_device_t;
+
+typedef struct {
+    uint32_t devices;           // In the table now
+    uint32_t added;
+    uint32_t evicted;           // Pushed out by a new device while fresh
+    uint32_t expired;           // Aged out
+} ble_devices_stats_t;
+
+// Empty the table; also required before first use
+void ble_devices_reset(void);
+
+// Record an advertising report of type evt_type (ESP_BLE_EVT_*), adding the
+// device if it is new (*is_new set). Scan responses do not count towards
+// the interval. Returns the device record, valid until the next update or
+// reset.
+ble_device_t *ble_devices_update(const uint8_t addr[6], uint8_t addr_type, int8_t rssi,
+                                 uint8_t evt_type, uint32_t now_ms, bool *is_new);
+
+ble_device_t *ble_devices_find(const uint8_t addr[6]);
+
+void ble_devices_set_name(ble_device_t *dev, const char *name, size_t len);
+
+// Drop devices older than the age limit. Updates already do this a few at
+// a time; call it when reports stop arriving.
+void ble_devices_expire(uint32_t now_ms);
+
+// Copy up to max devices, most recently seen first. Returns the count.
+size_t ble_devices_list(ble_device_t *out, size_t max);
+
+void ble_devices_get_stats(ble_devices_stats_t *stats);
@@ -0,0 +1,50 @@
+// components/bluetooth_module/include/ble_reports.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Lock-free single-producer, single-consumer ring of advertising reports.
+// The GAP callback (Bluedroid's BTC task) fills a slot in place and
+// returns; a worker task drains the ring and does all parsing, logging and
+// detection. When the worker falls behind, new reports are dropped and
+// counted instead of stalling the host stack.
+
+#define BLE_REPORTS_CAPACITY    64      // Power of two
+#define BLE_REPORT_DATA_MAX     62      // Advertising data plus scan response
+
+typedef struct {
+    uint32_t timestamp_ms;
+    uint8_t addr[6];
+    uint8_t addr_type;          // BLE_ADDR_TYPE_*
+    uint8_t evt_type;           // ESP_BLE_EVT_*
+    int8_t rssi;
+    uint8_t adv_len;
+    uint8_t rsp_len;
+    uint8_t data[BLE_REPORT_DATA_MAX];  // adv_len bytes, then rsp_len
+} ble_report_t;
+
+typedef struct {
+    uint32_t received;
+    uint32_t dropped;           // Ring full
+    uint32_t processed;
+    uint32_t received_per_s;    // Over the last complete second
+    uint32_t dropped_per_s;
+    uint32_t processed_per_s;
+    uint32_t high_water;        // Most reports waiting at once
+} ble_reports_stats_t;
+
+// Producer: claim the next slot, or NULL (counted as dropped) if the ring
+// is full. Fill it and publish it with ble_reports_commit.
+ble_report_t *ble_reports_reserve(void);
+void ble_reports_commit(void);
+
+// Consumer: the oldest waiting report, or NULL. Valid until
+// ble_reports_release.
+const ble_report_t *ble_reports_peek(void);
+void ble_reports_release(void);
+
+// Consumer: roll the per-second rates once a second has passed
+void ble_reports_tick(uint32_t now_ms);
+
+void ble_reports_get_stats(ble_reports_stats_t *stats);
@@ -0,0 +1,55 @@
+// components/bluetooth_module/include/ble_spoof.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_adv.h"
+
+// Per-address clone detector. Two transmitters sharing one address show up
+// as two interleaved populations: RSSI samples that alternate between two
+// levels, or report gaps that alternate between two values no single
+// advertiser produces. Each model is fixed size and every report costs a
+// constant amount of work, so it lives in the device table record.
+
+#define BLE_SPOOF_RSSI          0x01    // Two interleaved RSSI levels
+#define BLE_SPOOF_INTERVAL      0x02    // Two interleaved report gaps
+#define BLE_SPOOF_PAYLOAD       0x04    // Alternating payloads; evidence only
+
+// Half-octave bins of report gaps from 20 ms to 10.24 s
+#define BLE_SPOOF_INTERVAL_BINS 18
+
+// Up to two populations of one measurement, tracked by online 2-means
+typedef struct {
+    float mean[2];
+    float var[2];
+    float weight[2];            // Share of recent samples
+    float switch_rate;          // How often consecutive samples change population
+    uint8_t count;              // Populations in use
+    uint8_t last;               // Population of the latest sample
+} ble_spoof_split_t;
+
+typedef struct {
+    ble_spoof_split_t rssi;                     // dBm
+    ble_spoof_split_t interval;                 // ms, missed reports folded out
+    uint8_t interval_hist[BLE_SPOOF_INTERVAL_BINS];
+    uint32_t fingerprint[2];                    // Last two distinct payloads
+    float payload_switch_rate;
+    uint8_t payload_last;
+    uint16_t samples;                           // Saturating
+    uint8_t evidence;           // Clone reports less clean ones, bounded
+    bool flagged;               // Cloned; set and cleared with hysteresis
+} ble_spoof_model_t;
+
+// Hash of the parts of a payload that stay fixed for one firmware: flags,
+// name, TX power, service UUIDs and the manufacturer and service data
+// owners. Never 0.
+uint32_t ble_spoof_fingerprint(const ble_adv_info_t *info);
+
+// Fold one report into a zeroed or previously updated model. gap_ms is the
+// time since the previous report from the address, 0 for the first;
+// fingerprint is 0 to leave the payload model alone (scan responses).
+// Returns the BLE_SPOOF_* reasons the address looks cloned for now.
+uint8_t ble_spoof_update(ble_spoof_model_t *m, int8_t rssi, uint32_t gap_ms, uint32_t fingerprint);
+
+// Centre of the busiest interval bin in ms, 0 before any gap was seen
+uint32_t ble_spoof_typical_interval(const ble_spoof_model_t *m);
@@ -36,5 +36,7 @@ esp_err_t start_bluetooth_challenge(bluetooth_challenge_type_t type);
 // Stop the current challenge
 esp_err_t stop_bluetooth_challenge(void);
 
-// Get current challenge status
+// Get current challenge status: the active challenge and scan report
+// counters and the number of cloned addresses flagged, as a JSON object,
+// NUL-terminated
 esp_err_t get_bluetooth_challenge_status(void* status_buffer, size_t buffer_size);
@@ -84,7 +84,40 @@ void display_show_alert(const char *message) {
     ssd1306_refresh_gram(ssd1306_dev);
 }
 
+// Vertical bars scaled to 0-100, one per value, below a title line
+void display_show_bar_chart(const char *title, const uint8_t *values, size_t count) {
+    // Modules may report before (or without) a display being set up
+    if (ssd1306_dev == NULL || count == 0) return;
+
+    ssd1306_clear_screen(ssd1306_dev, 0x00);
+    ssd1306_draw_string(ssd1306_dev, 0, 0, title, 1, 1);
+
+    // Chart area below the 8-pixel title, with a baseline on the last row
+    const uint8_t top = 10, bottom = 63, height = bottom - top;
+    uint8_t slot = 128 / count;
+    uint8_t bar = slot > 2 ? slot - 1 : slot;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t value = values[i] > 100 ? 100 : values[i];
+        uint8_t h = (value * height + 99) / 100;
+        if (h > 0) {
+            ssd1306_fill_rectangle(ssd1306_dev, i * slot, bottom - h, bar, h, 1);
+        }
+    }
+    ssd1306_fill_rectangle(ssd1306_dev, 0, bottom, slot * count, 1, 1);
+
+    ssd1306_refresh_gram(ssd1306_dev);
+}
+
 void display_clear(void) {
     ssd1306_clear_screen(ssd1306_dev, 0x00);
     ssd1306_refresh_gram(ssd1306_dev);
-}
\ No newline at end of file
+}
+
+esp_err_t display_set_refresh_cb(ssd1306_refresh_cb_t cb, void *ctx) {
+    if (ssd1306_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ssd1306_set_refresh_cb(ssd1306_dev, cb, ctx);
+    return ESP_OK;
+}
@@ -3,6 +3,7 @@
 
 #include "esp_err.h"
 #include "driver/i2c.h"
+#include "ssd1306.h"
 
 // Display configuration structure
 typedef struct {
@@ -24,4 +25,9 @@ esp_err_t display_init(display_config_t *config);
 void display_show_menu(const menu_item_t *items, size_t num_items, size_t selected);
 void display_show_progress(const char *message, uint8_t progress);
 void display_show_alert(const char *message);
+void display_show_bar_chart(const char *title, const uint8_t *values, size_t count);
 void display_clear(void);
+
+// Observe every screen update, e.g. to mirror it elsewhere. Fails if the
+// display is not initialized.
+esp_err_t display_set_refresh_cb(ssd1306_refresh_cb_t cb, void *ctx);
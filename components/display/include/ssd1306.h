@@ -8,9 +8,19 @@
 extern "C" {
 #endif
 
+// Display dimensions
+#define SSD1306_WIDTH       128
+#define SSD1306_HEIGHT      64
+#define SSD1306_PAGES       (SSD1306_HEIGHT / 8)
+
 // SSD1306 display handle
 typedef struct ssd1306_dev_t* ssd1306_handle_t;
 
+// Called by ssd1306_refresh_gram with the framebuffer (one byte per column
+// per 8-row page, page after page) and a bit per page that changed since
+// the previous refresh. Runs on the refreshing task; keep it short.
+typedef void (*ssd1306_refresh_cb_t)(const uint8_t *fb, uint8_t dirty_pages, void *ctx);
+
 // Create and initialize SSD1306 device
 ssd1306_handle_t ssd1306_create(i2c_port_t i2c_port, uint8_t i2c_addr);
 
@@ -19,6 +29,7 @@ esp_err_t ssd1306_clear_screen(ssd1306_handle_t dev, uint8_t fill_data);
 esp_err_t ssd1306_draw_string(ssd1306_handle_t dev, uint8_t x, uint8_t y, 
                              const char* text, uint8_t font_size, uint8_t color);
 esp_err_t ssd1306_refresh_gram(ssd1306_handle_t dev);
+void ssd1306_set_refresh_cb(ssd1306_handle_t dev, ssd1306_refresh_cb_t cb, void *ctx);
 esp_err_t ssd1306_display_on(ssd1306_handle_t dev, bool on);
 
 // Drawing primitives
@@ -21,22 +21,23 @@ static const char *TAG = "SSD1306";
 #define SSD1306_CMD_SET_HIGH_COLUMN         0x10
 #define SSD1306_CMD_SET_START_LINE          0x40
 #define SSD1306_CMD_SET_MEMORY_MODE         0x20
+#define SSD1306_CMD_SET_COLUMN_RANGE        0x21
+#define SSD1306_CMD_SET_PAGE_RANGE          0x22
 #define SSD1306_CMD_SET_PAGE_ADDRESS        0xB0
 #define SSD1306_CMD_SET_COM_SCAN_INC        0xC0
 #define SSD1306_CMD_SET_COM_SCAN_DEC        0xC8
 #define SSD1306_CMD_SET_SEGMENT_REMAP       0xA0
 #define SSD1306_CMD_SET_CHARGE_PUMP         0x8D
 
-// Display dimensions
-#define SSD1306_WIDTH       128
-#define SSD1306_HEIGHT      64
-#define SSD1306_PAGES       (SSD1306_HEIGHT / 8)
-
 // Structure to hold device information
 typedef struct ssd1306_dev_t {
     i2c_port_t i2c_port;
     uint8_t i2c_addr;
     uint8_t buffer[SSD1306_WIDTH * SSD1306_PAGES];
+    uint8_t shown[SSD1306_WIDTH * SSD1306_PAGES];   // What the panel holds
+    bool shown_valid;                               // False until the first refresh
+    ssd1306_refresh_cb_t refresh_cb;
+    void *refresh_ctx;
 } ssd1306_dev_t;
 
 // Font data (basic 8x8 font)
@@ -141,22 +142,46 @@ esp_err_t ssd1306_clear_screen(ssd1306_handle_t dev, uint8_t fill_data) {
     return ESP_OK;
 }
 
+// Send only the pages that differ from what the panel already shows
 esp_err_t ssd1306_refresh_gram(ssd1306_handle_t dev) {
-    esp_err_t ret;
-    
-    // Set column address
-    ret = ssd1306_write_cmd(dev, SSD1306_CMD_SET_LOW_COLUMN | 0x0);
-    ret |= ssd1306_write_cmd(dev, SSD1306_CMD_SET_HIGH_COLUMN | 0x0);
-    
-    // Set page address
+    esp_err_t ret = ESP_OK;
+    uint8_t dirty = 0;
+
     for (int i = 0; i < SSD1306_PAGES; i++) {
-        ret |= ssd1306_write_cmd(dev, SSD1306_CMD_SET_PAGE_ADDRESS | i);
-        ret |= ssd1306_write_data(dev, &dev->buffer[SSD1306_WIDTH * i], SSD1306_WIDTH);
+        uint8_t *page = &dev->buffer[SSD1306_WIDTH * i];
+        if (dev->shown_valid && memcmp(page, &dev->shown[SSD1306_WIDTH * i], SSD1306_WIDTH) == 0) {
+            continue;
+        }
+        dirty |= 1 << i;
+
+        // Horizontal addressing mode: restrict the window to this page
+        ret |= ssd1306_write_cmd(dev, SSD1306_CMD_SET_COLUMN_RANGE);
+        ret |= ssd1306_write_cmd(dev, 0);
+        ret |= ssd1306_write_cmd(dev, SSD1306_WIDTH - 1);
+        ret |= ssd1306_write_cmd(dev, SSD1306_CMD_SET_PAGE_RANGE);
+        ret |= ssd1306_write_cmd(dev, i);
+        ret |= ssd1306_write_cmd(dev, i);
+        ret |= ssd1306_write_data(dev, page, SSD1306_WIDTH);
+    }
+    if (dirty == 0) {
+        return ESP_OK;
+    }
+
+    if (ret == ESP_OK) {
+        memcpy(dev->shown, dev->buffer, sizeof(dev->shown));
+        dev->shown_valid = true;
+    }
+    if (dev->refresh_cb) {
+        dev->refresh_cb(dev->buffer, dirty, dev->refresh_ctx);
     }
-    
     return ret;
 }
 
+void ssd1306_set_refresh_cb(ssd1306_handle_t dev, ssd1306_refresh_cb_t cb, void *ctx) {
+    dev->refresh_cb = cb;
+    dev->refresh_ctx = ctx;
+}
+
 esp_err_t ssd1306_draw_pixel(ssd1306_handle_t dev, uint8_t x, uint8_t y, uint8_t color) {
     if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
         return ESP_ERR_INVALID_ARG;
@@ -0,0 +1,94 @@
+// components/event_stream/event_stream.c
+#include "event_stream.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert((EVENT_STREAM_CAPACITY & (EVENT_STREAM_CAPACITY - 1)) == 0,
+               "EVENT_STREAM_CAPACITY must be a power of two");
+
+static event_t ring[EVENT_STREAM_CAPACITY];
+static uint32_t head = 0;                  // Next sequence number
+static TaskHandle_t consumer = NULL;
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *source_names[EVENT_SRC_COUNT] = {"network", "bluetooth", "hardware", "web"};
+
+void event_stream_publish(event_source_t source, const char *type, const char *json, size_t len) {
+    if (len > EVENT_STREAM_PAYLOAD_MAX || source >= EVENT_SRC_COUNT) return;
+
+    uint32_t now = esp_log_timestamp();
+    taskENTER_CRITICAL(&ring_lock);
+    event_t *ev = &ring[head & (EVENT_STREAM_CAPACITY - 1)];
+    ev->seq = head;
+    ev->timestamp_ms = now;
+    ev->source = source;
+    ev->type = type;
+    ev->len = len;
+    memcpy(ev->payload, json, len);
+    head++;
+    TaskHandle_t notify = consumer;
+    taskEXIT_CRITICAL(&ring_lock);
+
+    if (notify != NULL) {
+        xTaskNotifyGive(notify);
+    }
+}
+
+uint32_t event_stream_head(void) {
+    taskENTER_CRITICAL(&ring_lock);
+    uint32_t h = head;
+    taskEXIT_CRITICAL(&ring_lock);
+    return h;
+}
+
+int event_stream_read(uint32_t *cursor, event_t *out, uint32_t *dropped) {
+    int ret = 0;
+    taskENTER_CRITICAL(&ring_lock);
+    if (head - *cursor > EVENT_STREAM_CAPACITY) {
+        uint32_t oldest = head - EVENT_STREAM_CAPACITY;
+        *dropped += oldest - *cursor;
+        *cursor = oldest;
+    }
+    if (*cursor != head) {
+        *out = ring[*cursor & (EVENT_STREAM_CAPACITY - 1)];
+        (*cursor)++;
+        ret = 1;
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+    return ret;
+}
+
+void event_stream_set_consumer(TaskHandle_t task) {
+    taskENTER_CRITICAL(&ring_lock);
+    consumer = task;
+    taskEXIT_CRITICAL(&ring_lock);
+}
+
+const char *event_stream_source_name(event_source_t source) {
+    return source < EVENT_SRC_COUNT ? source_names[source] : "unknown";
+}
+
+size_t event_json_escape(char *dst, size_t size, const char *src, size_t len) {
+    size_t out = 0;
+    for (size_t i = 0; i < len && src[i]; i++) {
+        unsigned char c = src[i];
+        char esc[7];
+        size_t n;
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = c;
+            n = 2;
+        } else if (c < 0x20 || c >= 0x7F) {
+            n = snprintf(esc, sizeof(esc), "\\u%04x", c);
+        } else {
+            esc[0] = c;
+            n = 1;
+        }
+        if (out + n >= size) break;
+        memcpy(dst + out, esc, n);
+        out += n;
+    }
+    if (size > 0) dst[out] = '\0';
+    return out;
+}
@@ -0,0 +1,57 @@
+// components/event_stream/include/event_stream.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Bounded multi-producer event ring shared by all challenge modules.
+// Producers never block: once the ring is full the oldest event is
+// overwritten. Each consumer keeps its own cursor (a sequence number), so
+// a slow consumer only loses events, it never holds up producers or other
+// consumers.
+
+#define EVENT_STREAM_CAPACITY       64      // Power of two
+#define EVENT_STREAM_PAYLOAD_MAX    120
+
+typedef enum {
+    EVENT_SRC_NETWORK,
+    EVENT_SRC_BLUETOOTH,
+    EVENT_SRC_HARDWARE,
+    EVENT_SRC_WEB,
+    EVENT_SRC_COUNT
+} event_source_t;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t timestamp_ms;
+    uint8_t source;                         // event_source_t
+    uint8_t len;
+    const char *type;                       // Static string, e.g. "beacon"
+    char payload[EVENT_STREAM_PAYLOAD_MAX]; // One JSON object, not terminated
+} event_t;
+
+// Publish a JSON object as an event. Payloads longer than
+// EVENT_STREAM_PAYLOAD_MAX are dropped. Task context only.
+void event_stream_publish(event_source_t source, const char *type, const char *json, size_t len);
+
+// Sequence number the next published event will get
+uint32_t event_stream_head(void);
+
+// Copy the event at *cursor and advance the cursor. Returns 0 when the
+// consumer is up to date. If the cursor fell more than the ring capacity
+// behind, it is moved to the oldest retained event and the number of
+// events skipped is added to *dropped.
+int event_stream_read(uint32_t *cursor, event_t *out, uint32_t *dropped);
+
+// Task to wake (xTaskNotifyGive) whenever an event is published
+void event_stream_set_consumer(TaskHandle_t task);
+
+// Name of an event source for display
+const char *event_stream_source_name(event_source_t source);
+
+// Write src as the inside of a JSON string (quotes not included), always
+// NUL-terminated. Bytes outside printable ASCII are written as \u00XX so
+// arbitrary SSIDs stay valid UTF-8. Returns the length written.
+size_t event_json_escape(char *dst, size_t size, const char *src, size_t len);
@@ -6,6 +6,8 @@
 #include "freertos/task.h"
 #include "esp_random.h"
 #include "esp_secure_boot.h"
+#include "event_stream.h"
+#include <stdio.h>
 
 static const char *TAG = "hardware_challenges";
 
@@ -40,6 +42,10 @@ void voltage_glitch_task(void *pvParameters) {
         // Check for voltage anomalies
         if (adc_raw < 1000 || adc_raw > 3000) {
             ESP_LOGW(TAG, "Voltage glitch detected! Raw ADC: %d", adc_raw);
+
+            char json[24];
+            int n = snprintf(json, sizeof(json), "{\"raw\":%d}", adc_raw);
+            event_stream_publish(EVENT_SRC_HARDWARE, "glitch", json, n);
         }
         
         vTaskDelay(pdMS_TO_TICKS(100));
@@ -93,6 +99,11 @@ void timing_attack_task(void *pvParameters) {
         
         int64_t end = esp_timer_get_time();
         ESP_LOGI(TAG, "Time taken: %lld µs, Match: %d", end - start, match);
+
+        char json[48];
+        int n = snprintf(json, sizeof(json), "{\"us\":%lld,\"match\":%s}",
+                         (long long)(end - start), match ? "true" : "false");
+        event_stream_publish(EVENT_SRC_HARDWARE, "timing", json, n);
         
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
@@ -0,0 +1,131 @@
+// components/network_module/channel_survey.c
+#include "channel_survey.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "channel_survey";
+
+// Live counters (written by the promiscuous callback) and the latest
+// completed dwell of every channel
+static channel_survey_t live[SURVEY_MAX_CHANNEL + 1];
+static channel_survey_t results[SURVEY_MAX_CHANNEL + 1];
+
+// Legacy PHY rate codes (rx_ctrl.rate) in kbps. Codes 0-7 are DSSS/CCK,
+// with 5-7 using the short preamble; 8-15 are OFDM.
+static const uint16_t legacy_rate_kbps[16] = {
+    1000, 2000, 5500, 11000, 1000, 2000, 5500, 11000,
+    48000, 24000, 12000, 6000, 54000, 36000, 18000, 9000
+};
+
+// HT data bits per 4 us symbol for MCS 0-7, single stream
+static const uint16_t ht_dbps_20mhz[8] = {26, 52, 78, 104, 156, 208, 234, 260};
+static const uint16_t ht_dbps_40mhz[8] = {54, 108, 162, 216, 324, 432, 486, 540};
+
+static const char *frame_type_names[SURVEY_FRAME_TYPES] = {"mgmt", "ctrl", "data", "misc"};
+
+uint32_t channel_survey_airtime_us(const wifi_pkt_rx_ctrl_t *rx_ctrl, uint16_t len) {
+    uint32_t bits = 8 * (uint32_t)len;
+
+    if (rx_ctrl->sig_mode == 0) {
+        uint8_t code = rx_ctrl->rate & 0x0F;
+        uint32_t kbps = legacy_rate_kbps[code];
+
+        if (code < 8) {
+            uint32_t preamble = code >= 5 ? 96 : 192;
+            return preamble + (bits * 1000 + kbps - 1) / kbps;
+        }
+
+        // OFDM: 16 service + 6 tail bits, 4 us symbols, 20 us preamble
+        uint32_t dbps = kbps * 4 / 1000;
+        return 20 + 4 * ((16 + 6 + bits + dbps - 1) / dbps);
+    }
+
+    // HT mixed format: legacy preamble + HT-SIG + one HT-LTF per stream
+    uint8_t streams = (rx_ctrl->mcs >> 3) + 1;
+    uint32_t dbps = (rx_ctrl->cwb ? ht_dbps_40mhz : ht_dbps_20mhz)[rx_ctrl->mcs & 0x07] * streams;
+    return 32 + 4 * streams + 4 * ((16 + 6 + bits + dbps - 1) / dbps);
+}
+
+static inline uint8_t hist_bin(int value, int min, int width, int bins) {
+    int bin = (value - min) / width;
+    if (bin < 0) return 0;
+    if (bin >= bins) return bins - 1;
+    return bin;
+}
+
+void channel_survey_account(const wifi_pkt_rx_ctrl_t *rx_ctrl, wifi_promiscuous_pkt_type_t type) {
+    uint8_t channel = rx_ctrl->channel;
+    if (channel < SURVEY_FIRST_CHANNEL || channel > SURVEY_MAX_CHANNEL) return;
+    if (type >= SURVEY_FRAME_TYPES) return;
+
+    channel_survey_t *s = &live[channel];
+    uint16_t len = rx_ctrl->sig_len;
+
+    s->frames[type]++;
+    s->bytes[type] += len;
+    s->airtime_us[type] += channel_survey_airtime_us(rx_ctrl, len);
+    s->rssi_hist[hist_bin(rx_ctrl->rssi, SURVEY_RSSI_BIN_MIN, SURVEY_RSSI_BIN_WIDTH, SURVEY_RSSI_BINS)]++;
+    s->noise_hist[hist_bin(rx_ctrl->noise_floor, SURVEY_NOISE_BIN_MIN, SURVEY_NOISE_BIN_WIDTH, SURVEY_NOISE_BINS)]++;
+}
+
+void channel_survey_begin(uint8_t channel) {
+    if (channel > SURVEY_MAX_CHANNEL) return;
+    memset(&live[channel], 0, sizeof(live[channel]));
+}
+
+void channel_survey_end(uint8_t channel, uint32_t dwell_us) {
+    if (channel > SURVEY_MAX_CHANNEL) return;
+    results[channel] = live[channel];
+    results[channel].dwell_us = dwell_us;
+}
+
+esp_err_t channel_survey_get(uint8_t channel, channel_survey_t *out) {
+    if (channel < SURVEY_FIRST_CHANNEL || channel > SURVEY_MAX_CHANNEL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = results[channel];
+    return ESP_OK;
+}
+
+uint8_t channel_survey_utilization(const channel_survey_t *survey) {
+    if (survey->dwell_us == 0) return 0;
+
+    uint64_t busy = 0;
+    for (int t = 0; t < SURVEY_FRAME_TYPES; t++) {
+        busy += survey->airtime_us[t];
+    }
+    return busy >= survey->dwell_us ? 100 : busy * 100 / survey->dwell_us;
+}
+
+// Lower edge of the most populated histogram bin
+static int hist_mode(const uint16_t *hist, int bins, int min, int width) {
+    int best = 0;
+    for (int i = 1; i < bins; i++) {
+        if (hist[i] > hist[best]) best = i;
+    }
+    return min + best * width;
+}
+
+void channel_survey_log_summary(void) {
+    for (uint8_t ch = SURVEY_FIRST_CHANNEL; ch <= SURVEY_LAST_CHANNEL; ch++) {
+        const channel_survey_t *s = &results[ch];
+        uint32_t frames = 0, bytes = 0;
+        int busiest = 0;
+        for (int t = 0; t < SURVEY_FRAME_TYPES; t++) {
+            frames += s->frames[t];
+            bytes += s->bytes[t];
+            if (s->airtime_us[t] > s->airtime_us[busiest]) busiest = t;
+        }
+
+        if (frames == 0) {
+            ESP_LOGI(TAG, "Ch %2d: idle", ch);
+            continue;
+        }
+
+        ESP_LOGI(TAG, "Ch %2d: %3d%% busy, %lu frames, %lu bytes, mostly %s, RSSI ~%d dBm, noise ~%d dBm",
+                 ch, channel_survey_utilization(s), (unsigned long)frames, (unsigned long)bytes,
+                 frame_type_names[busiest],
+                 hist_mode(s->rssi_hist, SURVEY_RSSI_BINS, SURVEY_RSSI_BIN_MIN, SURVEY_RSSI_BIN_WIDTH),
+                 hist_mode(s->noise_hist, SURVEY_NOISE_BINS, SURVEY_NOISE_BIN_MIN, SURVEY_NOISE_BIN_WIDTH));
+    }
+}
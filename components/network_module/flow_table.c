@@ -0,0 +1,125 @@
+// components/network_module/flow_table.c
+#include "flow_table.h"
+#include <string.h>
+
+#define FLOW_KEY_LEN    13      // addr1 + addr2 + type_subtype
+#define FLOW_SEQ_MOD    4096
+
+// Probing touches only the 16-bit tag array (1 KiB), so a lookup usually
+// costs a single cache line before the matching entry is read. Tag 0 marks
+// an empty slot.
+static uint16_t tags[FLOW_TABLE_CAPACITY];
+static flow_entry_t entries[FLOW_TABLE_CAPACITY];
+
+// Indices of the busiest flows, kept sorted by packet count
+static uint16_t top[FLOW_TABLE_TOP_N];
+static size_t num_top = 0;
+
+static flow_table_stats_t stats;
+
+static uint32_t flow_hash(const uint8_t *key) {
+    // FNV-1a
+    uint32_t h = 0x811c9dc5;
+    for (int i = 0; i < FLOW_KEY_LEN; i++) {
+        h ^= key[i];
+        h *= 0x01000193;
+    }
+    return h;
+}
+
+static bool key_equals(const flow_entry_t *e, const uint8_t *key) {
+    return memcmp(e->addr1, key, 12) == 0 && e->type_subtype == key[12];
+}
+
+// Move a flow whose packet count just grew into its place in the top list
+static void top_update(uint16_t idx) {
+    flow_entry_t *e = &entries[idx];
+    size_t pos;
+
+    if (e->in_top) {
+        for (pos = 0; top[pos] != idx; pos++) {}
+    } else if (num_top < FLOW_TABLE_TOP_N) {
+        pos = num_top++;
+        top[pos] = idx;
+        e->in_top = 1;
+    } else if (e->packets > entries[top[num_top - 1]].packets) {
+        pos = num_top - 1;
+        entries[top[pos]].in_top = 0;
+        top[pos] = idx;
+        e->in_top = 1;
+    } else {
+        return;
+    }
+
+    while (pos > 0 && entries[top[pos - 1]].packets < e->packets) {
+        top[pos] = top[pos - 1];
+        top[pos - 1] = idx;
+        pos--;
+    }
+}
+
+void flow_table_reset(void) {
+    memset(tags, 0, sizeof(tags));
+    memset(&stats, 0, sizeof(stats));
+    num_top = 0;
+}
+
+bool flow_table_update(const captured_frame_t *frame) {
+    if (frame->len < sizeof(wifi_mac_hdr_t)) return false;
+
+    const wifi_mac_hdr_t *hdr = (const wifi_mac_hdr_t *)frame->payload;
+    uint8_t key[FLOW_KEY_LEN];
+    memcpy(key, hdr->addr1, 6);
+    memcpy(key + 6, hdr->addr2, 6);
+    key[12] = (hdr->frame_ctrl.type << 4) | hdr->frame_ctrl.subtype;
+
+    uint32_t h = flow_hash(key);
+    uint16_t tag = (h >> 16) | 1;
+    uint32_t slot = h & (FLOW_TABLE_CAPACITY - 1);
+
+    while (tags[slot] != 0) {
+        if (tags[slot] == tag && key_equals(&entries[slot], key)) break;
+        slot = (slot + 1) & (FLOW_TABLE_CAPACITY - 1);
+    }
+
+    uint16_t seq = hdr->sequence_ctrl >> 4;
+    flow_entry_t *e = &entries[slot];
+
+    if (tags[slot] == 0) {
+        if (stats.flows >= FLOW_TABLE_MAX_LOAD) {
+            stats.overflow++;
+            return false;
+        }
+        tags[slot] = tag;
+        memset(e, 0, sizeof(*e));
+        memcpy(e->addr1, key, 12);
+        e->type_subtype = key[12];
+        e->last_seq = seq;
+        stats.flows++;
+    } else if (hdr->frame_ctrl.retry) {
+        e->retries++;
+    } else {
+        uint16_t gap = (seq - e->last_seq - 1) & (FLOW_SEQ_MOD - 1);
+        // Large forward jumps are reordering or a restarted counter
+        if (gap < FLOW_SEQ_MOD / 2) e->seq_gaps += gap;
+        e->last_seq = seq;
+    }
+
+    e->packets++;
+    e->bytes += frame->len;
+    stats.packets++;
+    top_update(slot);
+    return true;
+}
+
+size_t flow_table_top(flow_entry_t *out, size_t max_out) {
+    size_t n = num_top < max_out ? num_top : max_out;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = entries[top[i]];
+    }
+    return n;
+}
+
+void flow_table_get_stats(flow_table_stats_t *out) {
+    *out = stats;
+}
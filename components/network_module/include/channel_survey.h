@@ -0,0 +1,50 @@
+// components/network_module/include/channel_survey.h
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+#define SURVEY_FIRST_CHANNEL    1
+#define SURVEY_LAST_CHANNEL     13
+#define SURVEY_MAX_CHANNEL      14
+#define SURVEY_FRAME_TYPES      4       // Indexed by wifi_promiscuous_pkt_type_t
+#define SURVEY_RSSI_BINS        8       // 10 dB bins starting at -100 dBm
+#define SURVEY_RSSI_BIN_MIN     (-100)
+#define SURVEY_RSSI_BIN_WIDTH   10
+#define SURVEY_NOISE_BINS       8       // 2 dB bins starting at -104 dBm
+#define SURVEY_NOISE_BIN_MIN    (-104)
+#define SURVEY_NOISE_BIN_WIDTH  2
+
+// Per-channel accumulators. Every field is a plain counter so a frame is
+// accounted with a handful of increments and no branches on history.
+typedef struct {
+    uint32_t frames[SURVEY_FRAME_TYPES];
+    uint32_t bytes[SURVEY_FRAME_TYPES];
+    uint32_t airtime_us[SURVEY_FRAME_TYPES];
+    uint16_t rssi_hist[SURVEY_RSSI_BINS];
+    uint16_t noise_hist[SURVEY_NOISE_BINS];
+    uint32_t dwell_us;                  // Listening time the counters cover
+} channel_survey_t;
+
+// Estimated on-air duration of a received frame from its PHY rate and length
+uint32_t channel_survey_airtime_us(const wifi_pkt_rx_ctrl_t *rx_ctrl, uint16_t len);
+
+// Account one frame to the channel in rx_ctrl. O(1); safe to call from the
+// promiscuous callback.
+void channel_survey_account(const wifi_pkt_rx_ctrl_t *rx_ctrl, wifi_promiscuous_pkt_type_t type);
+
+// Clear the live counters of a channel before dwelling on it
+void channel_survey_begin(uint8_t channel);
+
+// Publish the live counters of a channel as its latest result
+void channel_survey_end(uint8_t channel, uint32_t dwell_us);
+
+// Latest published result for a channel
+esp_err_t channel_survey_get(uint8_t channel, channel_survey_t *out);
+
+// Share of the dwell time the channel was busy, in percent
+uint8_t channel_survey_utilization(const channel_survey_t *survey);
+
+// Log one line per surveyed channel from the latest results
+void channel_survey_log_summary(void);
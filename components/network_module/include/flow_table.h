@@ -0,0 +1,44 @@
+// components/network_module/include/flow_table.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "network_challenges.h"
+
+// Fixed table geometry (capacity must be a power of two)
+#define FLOW_TABLE_CAPACITY     512
+#define FLOW_TABLE_MAX_LOAD     (FLOW_TABLE_CAPACITY * 3 / 4)
+#define FLOW_TABLE_TOP_N        8
+
+// One flow: frames of a single type/subtype from addr2 to addr1
+typedef struct {
+    uint8_t addr1[6];           // Receiver
+    uint8_t addr2[6];           // Transmitter
+    uint8_t type_subtype;       // (type << 4) | subtype
+    uint8_t in_top;             // Set while the flow is in the top-N list
+    uint16_t last_seq;          // Last sequence number seen
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t retries;
+    uint32_t seq_gaps;          // Frames missing according to sequence numbers
+} flow_entry_t;
+
+typedef struct {
+    uint32_t flows;             // Flows currently in the table
+    uint32_t packets;           // Frames accounted to a flow
+    uint32_t overflow;          // Frames rejected because the table was full
+} flow_table_stats_t;
+
+// Clear all flows and counters (start a new window)
+void flow_table_reset(void);
+
+// Account one captured frame. O(1) expected; never allocates.
+bool flow_table_update(const captured_frame_t *frame);
+
+// Current top-N flows by packet count, highest first. Maintained
+// incrementally on update, so this is a copy of at most FLOW_TABLE_TOP_N
+// entries. Returns the number written.
+size_t flow_table_top(flow_entry_t *out, size_t max_out);
+
+void flow_table_get_stats(flow_table_stats_t *stats);
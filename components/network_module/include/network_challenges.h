@@ -51,6 +51,7 @@ typedef struct {
             uint64_t timestamp;
             uint16_t beacon_interval;
             uint16_t capability;
+            uint8_t ssid_element_id;
             uint8_t ssid_length;
             uint8_t ssid[32];
             // Other beacon fields follow but we don't need them for training
@@ -59,17 +60,54 @@ typedef struct {
     };
 } __attribute__((packed)) wifi_packet_t;
 
+// Bytes of each accepted frame copied out of the promiscuous callback.
+// Covers the MAC header plus the fixed beacon fields and SSID element.
+#define CAPTURE_SNAPLEN 128
+
+// Frame record passed from the promiscuous callback to the analysis task
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint16_t len;                       // Original frame length
+    uint32_t queued_us;                 // Capture clock when the frame was queued
+    uint8_t payload[CAPTURE_SNAPLEN];   // First min(len, CAPTURE_SNAPLEN) bytes
+} captured_frame_t;
+
+// Capture pipeline counters, reset whenever a capture starts
+typedef struct {
+    uint32_t frames_seen;               // Frames delivered to the promiscuous callback
+    uint32_t frames_accepted;           // Frames that passed the filter program
+    uint32_t frames_dropped;            // Accepted frames lost to a full queue
+    uint32_t frames_processed;          // Frames consumed by the analysis task
+    uint32_t queue_high_water;          // Deepest queue observed by the analysis task
+    uint64_t queue_time_total_us;       // Time frames spent waiting in the queue
+    uint32_t queue_time_max_us;
+    uint64_t process_time_total_us;     // Time spent analysing frames
+    uint32_t process_time_max_us;
+} network_capture_stats_t;
+
+// Network description used by the evil twin challenge
+typedef struct {
+    uint8_t bssid[6];
+    char ssid[33];
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+    int8_t rssi;
+} network_info_t;
+
 // Challenge types
 typedef enum {
     NET_CHALLENGE_BEACON_ANALYSIS,
     NET_CHALLENGE_PACKET_ANALYSIS,
     NET_CHALLENGE_PROTOCOL_SECURITY,
     NET_CHALLENGE_DEAUTH_DETECTION,
-    NET_CHALLENGE_EVIL_TWIN
+    NET_CHALLENGE_EVIL_TWIN,
+    NET_CHALLENGE_CHANNEL_SURVEY,
+    NET_CHALLENGE_COUNT
 } network_challenge_type_t;
 
 // Function declarations
 esp_err_t network_challenges_init(void);
 esp_err_t start_network_challenge(network_challenge_type_t type);
 esp_err_t stop_network_challenge(void);
-esp_err_t get_challenge_status(void* status_buffer, size_t buffer_size);
\ No newline at end of file
+esp_err_t get_challenge_status(void* status_buffer, size_t buffer_size);
+esp_err_t network_get_capture_stats(network_capture_stats_t *stats);
\ No newline at end of file
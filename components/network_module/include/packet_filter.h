@@ -0,0 +1,61 @@
+// components/network_module/include/packet_filter.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Limits for the compiled filter program
+#define PKT_FILTER_MAX_RULES    16
+#define PKT_FILTER_MAX_CMPS     4   // Masked comparisons per rule (ANDed)
+#define PKT_FILTER_MAX_MATCH    8   // Bytes covered by a single comparison
+
+// Byte offsets into the 802.11 MAC header, for use in comparisons
+#define PKT_FILTER_OFF_FC       0
+#define PKT_FILTER_OFF_ADDR1    4
+#define PKT_FILTER_OFF_ADDR2    10
+#define PKT_FILTER_OFF_ADDR3    16
+
+typedef enum {
+    PKT_FILTER_DROP = 0,
+    PKT_FILTER_ACCEPT
+} pkt_filter_action_t;
+
+// Matches when (frame[offset + i] & mask[i]) == value[i] for every i < len.
+// Frames shorter than offset + len never match.
+typedef struct {
+    uint8_t offset;
+    uint8_t len;
+    uint8_t mask[PKT_FILTER_MAX_MATCH];
+    uint8_t value[PKT_FILTER_MAX_MATCH];
+} pkt_filter_cmp_t;
+
+// A rule fires when all of its comparisons match; rules are tried in order
+// and the first one that fires decides the action.
+typedef struct {
+    const char *name;
+    pkt_filter_cmp_t cmps[PKT_FILTER_MAX_CMPS];
+    uint8_t num_cmps;
+    pkt_filter_action_t action;
+} pkt_filter_rule_t;
+
+// Comparison builders for the common cases. subtype < 0 matches any subtype.
+pkt_filter_cmp_t pkt_filter_cmp_frame(uint8_t type, int subtype);
+pkt_filter_cmp_t pkt_filter_cmp_addr(uint8_t addr_offset, const uint8_t *prefix, size_t prefix_len);
+
+// Compile a rule table into the active program. Must be called while
+// promiscuous capture is disabled; resets all hit counters.
+esp_err_t packet_filter_compile(const pkt_filter_rule_t *rules, size_t num_rules,
+                                pkt_filter_action_t default_action);
+
+// Run the active program on a raw frame. Safe to call from the WiFi
+// promiscuous callback: no allocation, no locking, no logging.
+bool packet_filter_run(const uint8_t *frame, size_t len);
+
+// Copy out per-rule hit counters; the final slot is the default action.
+// Returns the number of counters written.
+size_t packet_filter_get_hits(uint32_t *hits, size_t max_hits);
+
+// Log the hit counters of the active program
+void packet_filter_log_stats(void);
@@ -1,66 +1,313 @@
 // components/network_module/network_challenges.c
 #include "network_challenges.h"
+#include "packet_filter.h"
+#include "flow_table.h"
+#include "channel_survey.h"
+#include "display.h"
+#include "oui_lookup.h"
+#include "event_stream.h"
 #include "esp_log.h"
 #include "esp_wifi.h"
-#include "esp_event.h"
-#include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#endif
 
 static const char *TAG = "network_challenges";
 
 // Current active challenge
 static network_challenge_type_t active_challenge = -1;
 static TaskHandle_t challenge_task_handle = NULL;
+// Given by a challenge task once it has cleaned up, just before it exits
+static SemaphoreHandle_t challenge_exited = NULL;
 
 // Queue for packet analysis
 static QueueHandle_t packet_queue = NULL;
 
+// Set while the channel survey owns the callback
+static volatile bool survey_active = false;
+
+// Capture statistics. The frame counters are written only from the
+// promiscuous callback, the rest only from the analysis task.
+static network_capture_stats_t capture_stats;
+
+// Microsecond clock used to timestamp the capture stages
+static inline uint32_t capture_time_us(void) {
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+#else
+    return (uint32_t)esp_timer_get_time();
+#endif
+}
+
 // Callback function for WiFi promiscuous mode
 static void wifi_promiscuous_cb(void *buf, wifi_promiscuous_pkt_type_t type) {
-    if (type != WIFI_PKT_MGMT) return;
+    const wifi_promiscuous_pkt_t *ppkt = (wifi_promiscuous_pkt_t *)buf;
+    capture_stats.frames_seen++;
 
-    wifi_promiscuous_pkt_t *ppkt = (wifi_promiscuous_pkt_t *)buf;
-    wifi_packet_t *pkt = (wifi_packet_t *)ppkt->payload;
-    
-    // Send packet to queue for analysis
-    if (xQueueSend(packet_queue, pkt, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Packet queue full!");
+    // The survey only needs rx_ctrl, so every frame type is accounted in
+    // place and nothing is queued
+    if (survey_active) {
+        channel_survey_account(&ppkt->rx_ctrl, type);
+        capture_stats.frames_accepted++;
+        capture_stats.frames_processed++;
+        return;
+    }
+
+    if (type != WIFI_PKT_MGMT && type != WIFI_PKT_DATA) return;
+
+    uint16_t len = ppkt->rx_ctrl.sig_len;
+
+    // Run the filter program first so rejected frames cost neither a copy
+    // nor a wakeup of the analysis task
+    if (!packet_filter_run(ppkt->payload, len)) return;
+    capture_stats.frames_accepted++;
+
+    captured_frame_t frame;
+    frame.rx_ctrl = ppkt->rx_ctrl;
+    frame.len = len;
+    frame.queued_us = capture_time_us();
+    memcpy(frame.payload, ppkt->payload, len < CAPTURE_SNAPLEN ? len : CAPTURE_SNAPLEN);
+
+    // Send frame to queue for analysis
+    if (xQueueSend(packet_queue, &frame, 0) != pdTRUE) {
+        capture_stats.frames_dropped++;
     }
 }
 
-// Task to handle beacon frame analysis
-static void beacon_analysis_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Starting Beacon Analysis Challenge");
-    
-    // Configure promiscuous mode
+// Receive the next captured frame and account its time in the queue
+static bool capture_receive(captured_frame_t *frame, TickType_t timeout) {
+    if (xQueueReceive(packet_queue, frame, timeout) != pdTRUE) {
+        return false;
+    }
+
+    uint32_t depth = uxQueueMessagesWaiting(packet_queue) + 1;
+    if (depth > capture_stats.queue_high_water) {
+        capture_stats.queue_high_water = depth;
+    }
+
+    uint32_t waited = capture_time_us() - frame->queued_us;
+    capture_stats.queue_time_total_us += waited;
+    if (waited > capture_stats.queue_time_max_us) {
+        capture_stats.queue_time_max_us = waited;
+    }
+    return true;
+}
+
+// Account the analysis time of a frame received at start_us
+static void capture_processed(uint32_t start_us) {
+    uint32_t spent = capture_time_us() - start_us;
+    capture_stats.frames_processed++;
+    capture_stats.process_time_total_us += spent;
+    if (spent > capture_stats.process_time_max_us) {
+        capture_stats.process_time_max_us = spent;
+    }
+}
+
+// Log filter hit counters and queue drops
+static void log_capture_stats(void) {
+    packet_filter_log_stats();
+    ESP_LOGI(TAG, "Frames seen: %lu, dropped (queue full): %lu, queue high-water: %lu",
+             (unsigned long)capture_stats.frames_seen, (unsigned long)capture_stats.frames_dropped,
+             (unsigned long)capture_stats.queue_high_water);
+}
+
+// Compile a filter program and enable promiscuous capture
+static void start_capture(const pkt_filter_rule_t *rules, size_t num_rules,
+                          pkt_filter_action_t default_action, uint32_t hw_filter_mask) {
+    memset(&capture_stats, 0, sizeof(capture_stats));
+    xQueueReset(packet_queue);
+    ESP_ERROR_CHECK(packet_filter_compile(rules, num_rules, default_action));
+
     wifi_promiscuous_filter_t filter = {
-        .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT
+        .filter_mask = hw_filter_mask
     };
     ESP_ERROR_CHECK(esp_wifi_set_promiscuous_filter(&filter));
     ESP_ERROR_CHECK(esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb));
     ESP_ERROR_CHECK(esp_wifi_set_promiscuous(true));
+}
 
-    wifi_packet_t pkt;
+// Beacon summary for the live event stream
+static void publish_beacon(const uint8_t *bssid, const char *ssid, uint8_t ssid_len,
+                           uint8_t channel, int8_t rssi, const char *vendor) {
+    char ssid_esc[33];          // Keeps the worst case within the payload limit
+    event_json_escape(ssid_esc, sizeof(ssid_esc), ssid, ssid_len);
+
+    char json[EVENT_STREAM_PAYLOAD_MAX];
+    int n = snprintf(json, sizeof(json), "{\"bssid\":\"" MACSTR "\",\"ssid\":\"%s\",\"ch\":%u,\"rssi\":%d,\"vendor\":\"%.16s\"}",
+                     MAC2STR(bssid), ssid_esc, channel, rssi, vendor);
+    if (n > 0 && n < (int)sizeof(json)) {
+        event_stream_publish(EVENT_SRC_NETWORK, "beacon", json, n);
+    }
+}
+
+// End of every challenge task; stop_network_challenge waits for this
+static void challenge_task_exit(void) {
+    xSemaphoreGive(challenge_exited);
+    vTaskDelete(NULL);
+}
+
+// Log and publish one captured beacon
+static void handle_beacon(const captured_frame_t *frame) {
+    // Fixed fields plus the SSID element header must have been captured,
+    // and the SSID is cut to the bytes that were
+    size_t captured = frame->len < CAPTURE_SNAPLEN ? frame->len : CAPTURE_SNAPLEN;
+    size_t ssid_offset = offsetof(wifi_packet_t, beacon.ssid);
+    if (captured < ssid_offset) return;
+
+    const wifi_packet_t *pkt = (const wifi_packet_t *)frame->payload;
+    size_t ssid_len = pkt->beacon.ssid_length;
+    if (ssid_len > sizeof(pkt->beacon.ssid)) ssid_len = sizeof(pkt->beacon.ssid);
+    if (ssid_len > captured - ssid_offset) ssid_len = captured - ssid_offset;
+
+    char vendor[48];
+    oui_lookup_vendor(pkt->hdr.addr3, vendor, sizeof(vendor));
+
+    ESP_LOGI(TAG, "Beacon Frame Detected:");
+    ESP_LOGI(TAG, "BSSID: " MACSTR " (%s)", MAC2STR(pkt->hdr.addr3), vendor);
+    ESP_LOGI(TAG, "SSID: %.*s", (int)ssid_len, pkt->beacon.ssid);
+    ESP_LOGI(TAG, "Channel: %d", frame->rx_ctrl.channel);
+    ESP_LOGI(TAG, "RSSI: %d", frame->rx_ctrl.rssi);
+    publish_beacon(pkt->hdr.addr3, (const char *)pkt->beacon.ssid, ssid_len,
+                   frame->rx_ctrl.channel, frame->rx_ctrl.rssi, vendor);
+}
+
+// Task to handle beacon frame analysis
+static void beacon_analysis_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Starting Beacon Analysis Challenge");
+
+    // Only beacons ever reach the queue
+    const pkt_filter_rule_t rules[] = {
+        {
+            .name = "beacon",
+            .cmps = { pkt_filter_cmp_frame(WIFI_FRAME_TYPE_MGMT, WIFI_MGMT_SUBTYPE_BEACON) },
+            .num_cmps = 1,
+            .action = PKT_FILTER_ACCEPT
+        }
+    };
+    start_capture(rules, sizeof(rules)/sizeof(rules[0]), PKT_FILTER_DROP, WIFI_PROMIS_FILTER_MASK_MGMT);
+
+    captured_frame_t frame;
+    TickType_t last_stats = xTaskGetTickCount();
     while (active_challenge == NET_CHALLENGE_BEACON_ANALYSIS) {
-        if (xQueueReceive(packet_queue, &pkt, pdMS_TO_TICKS(100)) == pdTRUE) {
-            // Analyze only beacon frames
-            if (pkt.hdr.frame_ctrl.type == WIFI_FRAME_TYPE_MGMT && 
-                pkt.hdr.frame_ctrl.subtype == WIFI_MGMT_SUBTYPE_BEACON) {
-                
-                ESP_LOGI(TAG, "Beacon Frame Detected:");
-                ESP_LOGI(TAG, "BSSID: " MACSTR, MAC2STR(pkt.hdr.addr3));
-                ESP_LOGI(TAG, "SSID: %.*s", pkt.beacon.ssid_length, pkt.beacon.ssid);
-                ESP_LOGI(TAG, "Channel: %d", ppkt->rx_ctrl.channel);
-                ESP_LOGI(TAG, "RSSI: %d", ppkt->rx_ctrl.rssi);
-            }
+        if (capture_receive(&frame, pdMS_TO_TICKS(100))) {
+            uint32_t start = capture_time_us();
+            handle_beacon(&frame);
+            capture_processed(start);
+        }
+
+        if (xTaskGetTickCount() - last_stats >= pdMS_TO_TICKS(10000)) {
+            log_capture_stats();
+            last_stats = xTaskGetTickCount();
         }
     }
 
     ESP_ERROR_CHECK(esp_wifi_set_promiscuous(false));
-    vTaskDelete(NULL);
+    challenge_task_exit();
+}
+
+// Task to handle packet analysis challenge
+static void packet_analysis_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Starting Packet Analysis Challenge");
+
+    // Management and data frames are all of interest; control frames carry
+    // no transmitter address or sequence number and are not captured
+    flow_table_reset();
+    start_capture(NULL, 0, PKT_FILTER_ACCEPT, WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA);
+
+    captured_frame_t frame;
+    flow_entry_t top[FLOW_TABLE_TOP_N];
+    TickType_t window_start = xTaskGetTickCount();
+    while (active_challenge == NET_CHALLENGE_PACKET_ANALYSIS) {
+        if (capture_receive(&frame, pdMS_TO_TICKS(100))) {
+            uint32_t start = capture_time_us();
+            flow_table_update(&frame);
+            capture_processed(start);
+        }
+
+        if (xTaskGetTickCount() - window_start < pdMS_TO_TICKS(5000)) continue;
+
+        // Summaries cover one window; the table is cleared afterwards so it
+        // never needs deletions and never fills up on a busy channel
+        flow_table_stats_t stats;
+        flow_table_get_stats(&stats);
+        size_t n = flow_table_top(top, FLOW_TABLE_TOP_N);
+
+        ESP_LOGI(TAG, "Flows: %lu, frames: %lu, table overflow: %lu, queue drops: %lu",
+                 (unsigned long)stats.flows, (unsigned long)stats.packets,
+                 (unsigned long)stats.overflow, (unsigned long)capture_stats.frames_dropped);
+        for (size_t i = 0; i < n; i++) {
+            ESP_LOGI(TAG, MACSTR " -> " MACSTR " type %d/%d: %lu pkts, %lu bytes, retry %lu%%, seq gaps %lu",
+                     MAC2STR(top[i].addr2), MAC2STR(top[i].addr1),
+                     top[i].type_subtype >> 4, top[i].type_subtype & 0x0F,
+                     (unsigned long)top[i].packets, (unsigned long)top[i].bytes,
+                     (unsigned long)(top[i].retries * 100 / top[i].packets),
+                     (unsigned long)top[i].seq_gaps);
+        }
+
+        flow_table_reset();
+        window_start = xTaskGetTickCount();
+    }
+
+    ESP_ERROR_CHECK(esp_wifi_set_promiscuous(false));
+    challenge_task_exit();
+}
+
+// Task to handle the channel utilization survey
+static void channel_survey_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Starting Channel Survey");
+
+    const TickType_t dwell = pdMS_TO_TICKS(200);
+    uint8_t utilization[SURVEY_LAST_CHANNEL - SURVEY_FIRST_CHANNEL + 1];
+
+    survey_active = true;
+    start_capture(NULL, 0, PKT_FILTER_DROP, WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_CTRL |
+                                            WIFI_PROMIS_FILTER_MASK_DATA | WIFI_PROMIS_FILTER_MASK_MISC);
+
+    while (active_challenge == NET_CHALLENGE_CHANNEL_SURVEY) {
+        for (uint8_t ch = SURVEY_FIRST_CHANNEL;
+             ch <= SURVEY_LAST_CHANNEL && active_challenge == NET_CHALLENGE_CHANNEL_SURVEY; ch++) {
+            channel_survey_begin(ch);
+            ESP_ERROR_CHECK(esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE));
+
+            // Cut short by stop_network_challenge
+            TickType_t start = xTaskGetTickCount();
+            ulTaskNotifyTake(pdTRUE, dwell);
+            uint32_t dwell_us = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS * 1000;
+            channel_survey_end(ch, dwell_us);
+
+            channel_survey_t result;
+            channel_survey_get(ch, &result);
+            utilization[ch - SURVEY_FIRST_CHANNEL] = channel_survey_utilization(&result);
+        }
+        if (active_challenge != NET_CHALLENGE_CHANNEL_SURVEY) break;
+
+        channel_survey_log_summary();
+        display_show_bar_chart("Channel busy %", utilization, sizeof(utilization));
+
+        char json[EVENT_STREAM_PAYLOAD_MAX];
+        int n = snprintf(json, sizeof(json), "{\"first\":%d,\"busy\":[", SURVEY_FIRST_CHANNEL);
+        for (size_t i = 0; i < sizeof(utilization); i++) {
+            n += snprintf(json + n, sizeof(json) - n, i ? ",%u" : "%u", utilization[i]);
+        }
+        n += snprintf(json + n, sizeof(json) - n, "]}");
+        event_stream_publish(EVENT_SRC_NETWORK, "survey", json, n);
+    }
+
+    survey_active = false;
+    ESP_ERROR_CHECK(esp_wifi_set_promiscuous(false));
+    challenge_task_exit();
 }
 
 // Task to handle protocol security challenge
@@ -75,14 +322,14 @@ static void protocol_security_task(void *pvParameters) {
     };
 
     while (active_challenge == NET_CHALLENGE_PROTOCOL_SECURITY) {
-        for (int i = 0; i < 5; i++) {
+        for (int i = 0; i < 5 && active_challenge == NET_CHALLENGE_PROTOCOL_SECURITY; i++) {
             ESP_LOGI(TAG, "Demonstrating %s:", security_types[i]);
             // Show security features and potential vulnerabilities
-            vTaskDelay(pdMS_TO_TICKS(5000));
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5000));
         }
     }
 
-    vTaskDelete(NULL);
+    challenge_task_exit();
 }
 
 // Task to handle evil twin detection challenge
@@ -95,7 +342,7 @@ static void evil_twin_task(void *pvParameters) {
 
     // Simulate detection of suspicious networks
     while (active_challenge == NET_CHALLENGE_EVIL_TWIN) {
-        for (int i = 0; i < 2; i++) {
+        for (int i = 0; i < 2 && active_challenge == NET_CHALLENGE_EVIL_TWIN; i++) {
             // Simulate finding a potential evil twin
             network_info_t suspicious = legitimate_networks[i];
             suspicious.bssid[5] ^= 0x01;  // Slightly modified BSSID
@@ -106,20 +353,29 @@ static void evil_twin_task(void *pvParameters) {
             ESP_LOGI(TAG, "Original BSSID: " MACSTR, MAC2STR(legitimate_networks[i].bssid));
             ESP_LOGI(TAG, "Suspicious BSSID: " MACSTR, MAC2STR(suspicious.bssid));
             
-            vTaskDelay(pdMS_TO_TICKS(3000));
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(3000));
         }
     }
 
-    vTaskDelete(NULL);
+    challenge_task_exit();
 }
 
 esp_err_t network_challenges_init(void) {
-    packet_queue = xQueueCreate(32, sizeof(wifi_promiscuous_pkt_t));
+    packet_queue = xQueueCreate(64, sizeof(captured_frame_t));
     if (packet_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create packet queue");
         return ESP_FAIL;
     }
 
+    challenge_exited = xSemaphoreCreateBinary();
+    if (challenge_exited == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+#if CONFIG_OUI_LOOKUP_BENCHMARK
+    oui_lookup_benchmark(100000);
+#endif
+
     ESP_LOGI(TAG, "Network challenges module initialized");
     return ESP_OK;
 }
@@ -137,10 +393,18 @@ esp_err_t start_network_challenge(network_challenge_type_t type) {
             xTaskCreate(beacon_analysis_task, "beacon_analysis", 4096, NULL, 5, &challenge_task_handle);
             break;
             
+        case NET_CHALLENGE_PACKET_ANALYSIS:
+            xTaskCreate(packet_analysis_task, "packet_analysis", 4096, NULL, 6, &challenge_task_handle);
+            break;
+            
         case NET_CHALLENGE_PROTOCOL_SECURITY:
             xTaskCreate(protocol_security_task, "protocol_security", 4096, NULL, 5, &challenge_task_handle);
             break;
             
+        case NET_CHALLENGE_CHANNEL_SURVEY:
+            xTaskCreate(channel_survey_task, "channel_survey", 4096, NULL, 5, &challenge_task_handle);
+            break;
+            
         case NET_CHALLENGE_EVIL_TWIN:
             xTaskCreate(evil_twin_task, "evil_twin", 4096, NULL, 5, &challenge_task_handle);
             break;
@@ -160,13 +424,23 @@ esp_err_t stop_network_challenge(void) {
     }
 
     active_challenge = -1;
-    vTaskDelay(pdMS_TO_TICKS(100));  // Give time for task to clean up
 
+    // Wake the task from any wait and let it clean up and exit by itself;
+    // deleting it mid-wait would leave promiscuous mode and the survey on
     if (challenge_task_handle != NULL) {
-        vTaskDelete(challenge_task_handle);
+        xTaskNotifyGive(challenge_task_handle);
+        xSemaphoreTake(challenge_exited, portMAX_DELAY);
         challenge_task_handle = NULL;
     }
 
     ESP_LOGI(TAG, "Stopped network challenge");
     return ESP_OK;
+}
+
+esp_err_t network_get_capture_stats(network_capture_stats_t *stats) {
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = capture_stats;
+    return ESP_OK;
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+// components/network_module/packet_filter.c
+#include "packet_filter.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "packet_filter";
+
+// Compiled comparison: up to 8 frame bytes loaded into a word and tested
+// with a single mask/compare
+typedef struct {
+    uint8_t offset;
+    uint8_t len;
+    uint16_t min_len;
+    uint64_t mask;
+    uint64_t value;
+} pkt_filter_insn_t;
+
+typedef struct {
+    uint8_t first_insn;
+    uint8_t num_insns;
+    uint8_t action;
+} pkt_filter_compiled_rule_t;
+
+// Active program. Instructions are stored contiguously so a frame walks a
+// single small array instead of chasing the caller's rule table.
+static pkt_filter_insn_t insns[PKT_FILTER_MAX_RULES * PKT_FILTER_MAX_CMPS];
+static pkt_filter_compiled_rule_t rules[PKT_FILTER_MAX_RULES];
+static const char *rule_names[PKT_FILTER_MAX_RULES];
+static size_t num_rules = 0;
+static uint8_t default_action = PKT_FILTER_ACCEPT;
+
+// Hit counters, written only from the promiscuous callback
+static uint32_t rule_hits[PKT_FILTER_MAX_RULES + 1];
+
+pkt_filter_cmp_t pkt_filter_cmp_frame(uint8_t type, int subtype) {
+    // First frame-control byte: protocol (2 bits), type (2), subtype (4)
+    pkt_filter_cmp_t cmp = {
+        .offset = PKT_FILTER_OFF_FC,
+        .len = 1,
+        .mask = {0x0C},
+        .value = {(uint8_t)((type & 0x03) << 2)}
+    };
+    if (subtype >= 0) {
+        cmp.mask[0] |= 0xF0;
+        cmp.value[0] |= (uint8_t)((subtype & 0x0F) << 4);
+    }
+    return cmp;
+}
+
+pkt_filter_cmp_t pkt_filter_cmp_addr(uint8_t addr_offset, const uint8_t *prefix, size_t prefix_len) {
+    pkt_filter_cmp_t cmp = {
+        .offset = addr_offset,
+        .len = prefix_len > 6 ? 6 : prefix_len
+    };
+    memset(cmp.mask, 0xFF, cmp.len);
+    memcpy(cmp.value, prefix, cmp.len);
+    return cmp;
+}
+
+esp_err_t packet_filter_compile(const pkt_filter_rule_t *rule_table, size_t count,
+                                pkt_filter_action_t action) {
+    if (count > PKT_FILTER_MAX_RULES || (count > 0 && rule_table == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t n = 0;
+    for (size_t r = 0; r < count; r++) {
+        const pkt_filter_rule_t *rule = &rule_table[r];
+        if (rule->num_cmps > PKT_FILTER_MAX_CMPS) {
+            ESP_LOGE(TAG, "Rule %u has too many comparisons", (unsigned)r);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        rules[r].first_insn = n;
+        rules[r].num_insns = rule->num_cmps;
+        rules[r].action = rule->action;
+        rule_names[r] = rule->name ? rule->name : "unnamed";
+
+        for (uint8_t c = 0; c < rule->num_cmps; c++) {
+            const pkt_filter_cmp_t *cmp = &rule->cmps[c];
+            if (cmp->len == 0 || cmp->len > PKT_FILTER_MAX_MATCH) {
+                ESP_LOGE(TAG, "Rule %u has an invalid comparison length", (unsigned)r);
+                return ESP_ERR_INVALID_ARG;
+            }
+
+            pkt_filter_insn_t *insn = &insns[n++];
+            insn->offset = cmp->offset;
+            insn->len = cmp->len;
+            insn->min_len = cmp->offset + cmp->len;
+            insn->mask = 0;
+            insn->value = 0;
+            memcpy(&insn->mask, cmp->mask, cmp->len);
+            memcpy(&insn->value, cmp->value, cmp->len);
+            insn->value &= insn->mask;
+        }
+    }
+
+    num_rules = count;
+    default_action = action;
+    memset(rule_hits, 0, sizeof(rule_hits));
+
+    ESP_LOGI(TAG, "Compiled %u rules (%u comparisons), default %s",
+             (unsigned)count, (unsigned)n, action == PKT_FILTER_ACCEPT ? "accept" : "drop");
+    return ESP_OK;
+}
+
+bool packet_filter_run(const uint8_t *frame, size_t len) {
+    for (size_t r = 0; r < num_rules; r++) {
+        const pkt_filter_insn_t *insn = &insns[rules[r].first_insn];
+        const pkt_filter_insn_t *end = insn + rules[r].num_insns;
+
+        for (; insn < end; insn++) {
+            if (len < insn->min_len) break;
+
+            uint64_t word = 0;
+            memcpy(&word, frame + insn->offset, insn->len);
+            if ((word & insn->mask) != insn->value) break;
+        }
+
+        if (insn == end) {
+            rule_hits[r]++;
+            return rules[r].action == PKT_FILTER_ACCEPT;
+        }
+    }
+
+    rule_hits[num_rules]++;
+    return default_action == PKT_FILTER_ACCEPT;
+}
+
+size_t packet_filter_get_hits(uint32_t *hits, size_t max_hits) {
+    size_t n = num_rules + 1;
+    if (n > max_hits) n = max_hits;
+    memcpy(hits, rule_hits, n * sizeof(uint32_t));
+    return n;
+}
+
+void packet_filter_log_stats(void) {
+    for (size_t r = 0; r < num_rules; r++) {
+        ESP_LOGI(TAG, "Rule %-16s %-6s hits: %lu", rule_names[r],
+                 rules[r].action == PKT_FILTER_ACCEPT ? "accept" : "drop",
+                 (unsigned long)rule_hits[r]);
+    }
+    ESP_LOGI(TAG, "Default %-13s %-6s hits: %lu", "",
+             default_action == PKT_FILTER_ACCEPT ? "accept" : "drop",
+             (unsigned long)rule_hits[num_rules]);
+}
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# components/oui_lookup/gen_oui_table.py
+#
+# Compiles an IEEE OUI registry CSV (https://standards-oui.ieee.org/oui/oui.csv
+# format: Registry,Assignment,Organization Name,Organization Address) into a C
+# source holding a minimal perfect hash table and compressed vendor strings.
+#
+# Lookup: bucket = mix(oui, 0) % num_buckets
+#         slot   = mix(oui, disp[bucket]) % num_keys
+# and the stored key at slot confirms a hit. Vendor names are deduplicated
+# and frequent words are replaced by single bytes >= 0x80 that index a word
+# dictionary.
+import argparse
+import csv
+from collections import Counter
+
+KEYS_PER_BUCKET = 4
+MAX_DISPLACEMENT = 0xFFFF
+MAX_DICT_WORDS = 128
+
+
+def mix(key, seed):
+    # murmur3 finalizer over the key xor a seed; mirrored in oui_lookup.c
+    x = (key ^ ((seed * 0x9E3779B9) & 0xFFFFFFFF)) & 0xFFFFFFFF
+    x ^= x >> 16
+    x = (x * 0x85EBCA6B) & 0xFFFFFFFF
+    x ^= x >> 13
+    x = (x * 0xC2B2AE35) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x
+
+
+def load_registry(path):
+    vendors = {}
+    with open(path, newline='', encoding='utf-8', errors='replace') as f:
+        for row in csv.reader(f):
+            if len(row) < 3 or row[0] not in ('MA-L', 'MAL'):
+                continue
+            try:
+                oui = int(row[1], 16)
+            except ValueError:
+                continue
+            name = ' '.join(row[2].split())
+            name = name.encode('ascii', 'replace').decode('ascii')
+            if name and oui not in vendors:
+                vendors[oui] = name
+    return vendors
+
+
+def build_mph(keys):
+    n = len(keys)
+    num_buckets = max(1, (n + KEYS_PER_BUCKET - 1) // KEYS_PER_BUCKET)
+    buckets = [[] for _ in range(num_buckets)]
+    for k in keys:
+        buckets[mix(k, 0) % num_buckets].append(k)
+
+    slots = [None] * n
+    disp = [0] * num_buckets
+    for b in sorted(range(num_buckets), key=lambda i: -len(buckets[i])):
+        members = buckets[b]
+        if not members:
+            continue
+        for d in range(1, MAX_DISPLACEMENT + 1):
+            targets = [mix(k, d) % n for k in members]
+            if len(set(targets)) == len(targets) and all(slots[t] is None for t in targets):
+                for k, t in zip(members, targets):
+                    slots[t] = k
+                disp[b] = d
+                break
+        else:
+            raise SystemExit('gen_oui_table: no displacement found, try fewer keys per bucket')
+    return slots, disp
+
+
+def build_dictionary(names):
+    counts = Counter(w for name in names for w in name.split(' ') if len(w) >= 3)
+    scored = sorted(((len(w) - 1) * c, w) for w, c in counts.items() if c >= 2)
+    return [w for _, w in reversed(scored[-MAX_DICT_WORDS:])]
+
+
+def encode_name(name, codes):
+    out = bytearray()
+    for i, word in enumerate(name.split(' ')):
+        if i:
+            out.append(ord(' '))
+        if word in codes:
+            out.append(0x80 + codes[word])
+        else:
+            out += word.encode('ascii')
+    return bytes(out)
+
+
+def c_bytes(data, indent='    ', per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ', '.join('0x%02x' % b for b in data[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def c_ints(values, indent='    ', per_line=12):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('csv', help='IEEE OUI registry CSV')
+    parser.add_argument('output', help='generated C source')
+    args = parser.parse_args()
+
+    vendors = load_registry(args.csv)
+    if not vendors:
+        raise SystemExit('gen_oui_table: no MA-L assignments in %s' % args.csv)
+
+    slots, disp = build_mph(sorted(vendors))
+
+    names = sorted(set(vendors.values()))
+    name_index = {name: i for i, name in enumerate(names)}
+    dictionary = build_dictionary(names)
+    codes = {w: i for i, w in enumerate(dictionary)}
+
+    blob = bytearray()
+    offsets = []
+    for name in names:
+        offsets.append(len(blob))
+        blob += encode_name(name, codes)
+    offsets.append(len(blob))
+
+    dict_blob = bytearray()
+    dict_offsets = []
+    for word in dictionary:
+        dict_offsets.append(len(dict_blob))
+        dict_blob += word.encode('ascii')
+    dict_offsets.append(len(dict_blob))
+
+    keys_bytes = bytearray()
+    for k in slots:
+        keys_bytes += bytes(((k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF))
+
+    raw_size = sum(len(n) for n in vendors.values())
+    with open(args.output, 'w') as out:
+        out.write('// Generated by gen_oui_table.py from %s -- do not edit\n' % args.csv.split('/')[-1])
+        out.write('// %d OUIs, %d vendors, %d dictionary words, names %d -> %d bytes\n'
+                  % (len(slots), len(names), len(dictionary), raw_size, len(blob)))
+        out.write('#include "oui_table.h"\n\n')
+        out.write('const uint32_t oui_table_num_keys = %d;\n' % len(slots))
+        out.write('const uint32_t oui_table_num_buckets = %d;\n\n' % len(disp))
+        out.write('const uint16_t oui_table_disp[] = {\n%s\n};\n\n' % c_ints(disp))
+        out.write('const uint8_t oui_table_keys[] = {\n%s\n};\n\n' % c_bytes(keys_bytes, per_line=15))
+        out.write('const uint16_t oui_table_vendor[] = {\n%s\n};\n\n'
+                  % c_ints([name_index[vendors[k]] for k in slots]))
+        out.write('const uint32_t oui_table_name_offsets[] = {\n%s\n};\n\n' % c_ints(offsets))
+        out.write('const uint8_t oui_table_names[] = {\n%s\n};\n\n' % c_bytes(blob))
+        out.write('const uint16_t oui_table_dict_offsets[] = {\n%s\n};\n\n' % c_ints(dict_offsets))
+        out.write('const char oui_table_dict[] = {\n%s\n};\n' % c_bytes(dict_blob or b'\0'))
+
+
+if __name__ == '__main__':
+    main()
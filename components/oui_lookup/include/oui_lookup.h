@@ -0,0 +1,15 @@
+// components/oui_lookup/include/oui_lookup.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Resolve the vendor of a MAC or public BD address (first three bytes are
+// the OUI). Writes the vendor name, "Private" for locally administered
+// addresses or "Unknown", NUL-terminated and truncated to fit. Returns true
+// only for registered OUIs. O(1), no RAM tables and no allocation.
+bool oui_lookup_vendor(const uint8_t *addr, char *name, size_t name_size);
+
+// Time lookups over a mix of registered and random OUIs and log the rate
+void oui_lookup_benchmark(uint32_t iterations);
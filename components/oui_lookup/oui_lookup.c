@@ -0,0 +1,122 @@
+// components/oui_lookup/oui_lookup.c
+#include "oui_lookup.h"
+#include "oui_table.h"
+#include "esp_log.h"
+#include <string.h>
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#endif
+
+static const char *TAG = "oui_lookup";
+
+// Must match mix() in gen_oui_table.py
+static inline uint32_t mix(uint32_t key, uint32_t seed) {
+    uint32_t x = key ^ (seed * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// Slot holding the OUI, or -1 if it is not registered
+static int32_t find_slot(uint32_t oui) {
+    uint32_t bucket = mix(oui, 0) % oui_table_num_buckets;
+    uint32_t slot = mix(oui, oui_table_disp[bucket]) % oui_table_num_keys;
+    const uint8_t *key = &oui_table_keys[slot * 3];
+    uint32_t stored = ((uint32_t)key[0] << 16) | ((uint32_t)key[1] << 8) | key[2];
+    return stored == oui ? (int32_t)slot : -1;
+}
+
+// Expand dictionary codes of a vendor name into the caller's buffer
+static void decode_name(uint16_t vendor, char *name, size_t name_size) {
+    size_t out = 0;
+    for (uint32_t i = oui_table_name_offsets[vendor];
+         i < oui_table_name_offsets[vendor + 1] && out + 1 < name_size; i++) {
+        uint8_t c = oui_table_names[i];
+        if (c < 0x80) {
+            name[out++] = c;
+            continue;
+        }
+        uint16_t start = oui_table_dict_offsets[c - 0x80];
+        uint16_t end = oui_table_dict_offsets[c - 0x80 + 1];
+        size_t len = end - start;
+        if (len > name_size - 1 - out) len = name_size - 1 - out;
+        memcpy(&name[out], &oui_table_dict[start], len);
+        out += len;
+    }
+    name[out] = '\0';
+}
+
+static void copy_name(const char *src, char *name, size_t name_size) {
+    strncpy(name, src, name_size - 1);
+    name[name_size - 1] = '\0';
+}
+
+bool oui_lookup_vendor(const uint8_t *addr, char *name, size_t name_size) {
+    if (addr == NULL || name == NULL || name_size == 0) return false;
+
+    // Locally administered (randomized) addresses carry no vendor
+    if (addr[0] & 0x02) {
+        copy_name("Private", name, name_size);
+        return false;
+    }
+
+    uint32_t oui = ((uint32_t)addr[0] << 16) | ((uint32_t)addr[1] << 8) | addr[2];
+    int32_t slot = find_slot(oui);
+    if (slot < 0) {
+        copy_name("Unknown", name, name_size);
+        return false;
+    }
+
+    decode_name(oui_table_vendor[slot], name, name_size);
+    return true;
+}
+
+static int64_t bench_time_us(void) {
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+void oui_lookup_benchmark(uint32_t iterations) {
+    if (iterations == 0) return;
+
+    // Alternate registered OUIs from the table with pseudo-random universal
+    // ones (fixed xorshift seed so runs are comparable)
+    uint8_t addrs[64][6];
+    uint32_t state = 0x2545F491;
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j < 6; j++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            addrs[i][j] = state;
+        }
+        addrs[i][0] &= ~0x03;
+        if (i % 2 == 0) {
+            memcpy(addrs[i], &oui_table_keys[(state % oui_table_num_keys) * 3], 3);
+        }
+    }
+
+    char name[48];
+    uint32_t hits = 0;
+    int64_t start = bench_time_us();
+    for (uint32_t i = 0; i < iterations; i++) {
+        hits += oui_lookup_vendor(addrs[i & 63], name, sizeof(name));
+    }
+    int64_t elapsed = bench_time_us() - start;
+
+    ESP_LOGI(TAG, "%lu lookups (%lu hits) in %lld us: %.0f lookups/s, %lu OUIs",
+             (unsigned long)iterations, (unsigned long)hits, (long long)elapsed,
+             elapsed > 0 ? iterations * 1e6 / elapsed : 0.0,
+             (unsigned long)oui_table_num_keys);
+}
@@ -0,0 +1,16 @@
+// components/oui_lookup/oui_table.h
+#pragma once
+
+#include <stdint.h>
+
+// Tables emitted by gen_oui_table.py. All of them are const and stay in
+// flash; see the generator for the hash layout.
+extern const uint32_t oui_table_num_keys;
+extern const uint32_t oui_table_num_buckets;
+extern const uint16_t oui_table_disp[];
+extern const uint8_t oui_table_keys[];              // 3 bytes per slot
+extern const uint16_t oui_table_vendor[];           // Vendor index per slot
+extern const uint32_t oui_table_name_offsets[];     // num_vendors + 1 entries
+extern const uint8_t oui_table_names[];             // Compressed vendor names
+extern const uint16_t oui_table_dict_offsets[];
+extern const char oui_table_dict[];                 // Dictionary words
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# components/web_module/gen_assets.py
+#
+# Precompresses the web UI for embedding. Every file in www/ is gzipped
+# (maximum level, no timestamp, so builds are reproducible) into
+# <out-dir>/<name>.gz, and a C table describing the assets is written for
+# web_assets.c.
+#
+# index.html is served at "/" and revalidated on every load. Other assets
+# get a content fingerprint in their URL (app.js -> app.1a2b3c4d.js), the
+# references in index.html are rewritten, and they are cached for a year.
+# The strong ETag is a hash of the compressed bytes actually served.
+import argparse
+import gzip
+import hashlib
+import os
+import re
+
+CONTENT_TYPES = {
+    '.html': 'text/html',
+    '.js': 'application/javascript',
+    '.css': 'text/css',
+    '.svg': 'image/svg+xml',
+    '.png': 'image/png',
+    '.ico': 'image/x-icon',
+    '.json': 'application/json',
+}
+
+CACHE_REVALIDATE = 'no-cache'
+CACHE_IMMUTABLE = 'public, max-age=31536000, immutable'
+
+
+def symbol(name):
+    return '_binary_' + re.sub(r'[^A-Za-z0-9]', '_', name)
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--out-dir', required=True, help='directory for the .gz files')
+    parser.add_argument('--table', required=True, help='generated C source')
+    parser.add_argument('files', nargs='+', help='www files; must include index.html')
+    args = parser.parse_args()
+
+    files = {os.path.basename(p): p for p in args.files}
+    if 'index.html' not in files:
+        raise SystemExit('gen_assets: www/index.html is missing')
+
+    assets = []
+    renames = {}
+    for name in sorted(files):
+        if name == 'index.html':
+            continue
+        with open(files[name], 'rb') as f:
+            data = f.read()
+        stem, ext = os.path.splitext(name)
+        if ext not in CONTENT_TYPES:
+            raise SystemExit('gen_assets: no content type for %s' % name)
+        url = '/%s.%s%s' % (stem, hashlib.sha256(data).hexdigest()[:8], ext)
+        renames[name] = url
+        assets.append((name, url, CONTENT_TYPES[ext], CACHE_IMMUTABLE, compress(data), len(data)))
+
+    with open(files['index.html'], 'rb') as f:
+        index = f.read().decode('utf-8')
+    for name, url in renames.items():
+        index = re.sub(r'(src|href)="/?%s"' % re.escape(name), r'\1="%s"' % url, index)
+    index = index.encode('utf-8')
+    assets.insert(0, ('index.html', '/', 'text/html', CACHE_REVALIDATE, compress(index), len(index)))
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    lines = ['// Generated by gen_assets.py -- do not edit', '#include "web_assets.h"', '']
+    for name, url, ctype, cache, gz, raw_len in assets:
+        with open(os.path.join(args.out_dir, name + '.gz'), 'wb') as f:
+            f.write(gz)
+        sym = symbol(name + '.gz')
+        lines.append('extern const uint8_t %s_start[] asm("%s_start");' % (sym, sym))
+        lines.append('extern const uint8_t %s_end[] asm("%s_end");' % (sym, sym))
+    lines.append('')
+
+    lines.append('const web_asset_t web_assets[] = {')
+    for name, url, ctype, cache, gz, raw_len in assets:
+        sym = symbol(name + '.gz')
+        etag = hashlib.sha256(gz).hexdigest()[:16]
+        lines.append('    {   // %s: %d -> %d bytes' % (name, raw_len, len(gz)))
+        lines.append('        .uri = "%s",' % url)
+        lines.append('        .content_type = "%s",' % ctype)
+        lines.append('        .etag = "\\"%s\\"",' % etag)
+        lines.append('        .cache_control = "%s",' % cache)
+        lines.append('        .data = %s_start,' % sym)
+        lines.append('        .end = %s_end,' % sym)
+        lines.append('    },')
+    lines.append('};')
+    lines.append('')
+    lines.append('const size_t web_assets_count = %d;' % len(assets))
+
+    with open(args.table, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    main()
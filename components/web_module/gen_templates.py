@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# components/web_module/gen_templates.py
+#
+# Compiles HTML templates into const fragment tables for web_template.c.
+# Each template becomes a list of parts: literal text, {{name}} slots
+# (HTML-escaped on render) and {{!name}} slots (sent raw). Slot names are
+# numbered per template in order of first use and exported as an enum.
+import argparse
+import os
+import re
+
+SLOT = re.compile(r'\{\{(!?)([a-z_][a-z0-9_]*)\}\}')
+MAX_LITERAL = 0xFFFF
+
+
+def c_string(text):
+    out = []
+    for ch in text.encode('utf-8'):
+        c = chr(ch)
+        if c == '\\':
+            out.append('\\\\')
+        elif c == '"':
+            out.append('\\"')
+        elif c == '\n':
+            out.append('\\n')
+        elif c == '\t':
+            out.append('\\t')
+        elif 0x20 <= ch < 0x7F and c != '?':
+            out.append(c)
+        else:
+            # Octal keeps following hex digits from joining the escape
+            out.append('\\%03o' % ch)
+    return '"' + ''.join(out) + '"'
+
+
+def compile_template(path):
+    with open(path, encoding='utf-8') as f:
+        text = f.read()
+    if '{{' in SLOT.sub('', text):
+        raise SystemExit('gen_templates: malformed slot in %s' % path)
+
+    parts, slots = [], []
+    pos = 0
+    for m in SLOT.finditer(text):
+        if m.start() > pos:
+            parts.append(('TPL_PART_LITERAL', 0, text[pos:m.start()]))
+        name = m.group(2)
+        if name not in slots:
+            slots.append(name)
+        mode = 'TPL_PART_RAW' if m.group(1) else 'TPL_PART_ESCAPED'
+        parts.append((mode, slots.index(name), None))
+        pos = m.end()
+    if pos < len(text):
+        parts.append(('TPL_PART_LITERAL', 0, text[pos:]))
+
+    for kind, _, literal in parts:
+        if literal is not None and len(literal.encode('utf-8')) > MAX_LITERAL:
+            raise SystemExit('gen_templates: literal too long in %s' % path)
+    return parts, slots
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('source', help='generated C source')
+    parser.add_argument('header', help='generated header')
+    parser.add_argument('templates', nargs='+', help='template files')
+    args = parser.parse_args()
+
+    src = ['// Generated by gen_templates.py -- do not edit', '#include "web_templates.h"', '']
+    hdr = ['// Generated by gen_templates.py -- do not edit', '#pragma once', '',
+           '#include "web_template.h"', '']
+
+    for path in sorted(args.templates):
+        name = re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0])
+        parts, slots = compile_template(path)
+
+        hdr.append('enum {')
+        for i, slot in enumerate(slots):
+            hdr.append('    TPL_%s_%s = %d,' % (name.upper(), slot.upper(), i))
+        hdr.append('    TPL_%s_NUM_SLOTS = %d,' % (name.upper(), len(slots)))
+        hdr.append('};')
+        hdr.append('extern const web_template_t tpl_%s;' % name)
+        hdr.append('')
+
+        src.append('static const tpl_part_t %s_parts[] = {' % name)
+        for kind, slot, literal in parts:
+            if literal is None:
+                src.append('    {%s, %d, 0, NULL},' % (kind, slot))
+            else:
+                src.append('    {%s, 0, %d, %s},' % (kind, len(literal.encode('utf-8')), c_string(literal)))
+        src.append('};')
+        src.append('')
+        src.append('const web_template_t tpl_%s = {' % name)
+        src.append('    .name = "%s",' % name)
+        src.append('    .parts = %s_parts,' % name)
+        src.append('    .num_parts = %d,' % len(parts))
+        src.append('    .num_slots = %d,' % len(slots))
+        src.append('};')
+        src.append('')
+
+    with open(args.source, 'w') as f:
+        f.write('\n'.join(src) + '\n')
+    with open(args.header, 'w') as f:
+        f.write('\n'.join(hdr) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,46 @@
+// components/web_module/include/json_scan.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal in-place JSON tokenizer (jsmn style). Tokens are offsets into the
+// caller's buffer; nothing is copied or allocated.
+
+#define JSON_SCAN_MAX_DEPTH     8
+
+typedef enum {
+    JSON_TOKEN_OBJECT,
+    JSON_TOKEN_ARRAY,
+    JSON_TOKEN_STRING,          // start/end exclude the quotes
+    JSON_TOKEN_PRIMITIVE,       // Number, true, false or null
+} json_token_type_t;
+
+typedef struct {
+    uint8_t type;               // json_token_type_t
+    uint8_t depth;              // Nesting level, 0 for the root value
+    uint16_t size;              // Members (object) or elements (array)
+    uint16_t start;
+    uint16_t end;
+} json_token_t;
+
+typedef enum {
+    JSON_SCAN_ERR_INVALID = -1, // Malformed input
+    JSON_SCAN_ERR_NOMEM = -2,   // More tokens than max_tokens
+    JSON_SCAN_ERR_DEPTH = -3,   // Nested deeper than JSON_SCAN_MAX_DEPTH
+} json_scan_err_t;
+
+// Tokenize one JSON value of at most 65535 bytes. Returns the number of
+// tokens written in document order, or a json_scan_err_t.
+int json_tokenize(const char *js, size_t len, json_token_t *tokens, size_t max_tokens);
+
+// Value of a member of the root object, or NULL. Keys are compared as raw
+// (still escaped) bytes.
+const json_token_t *json_object_get(const char *js, const json_token_t *tokens, int count,
+                                    const char *key);
+
+// Unescape a string token in place and NUL-terminate it. Returns a pointer
+// into js, or NULL if the token is not a string or has a bad escape. Only
+// the token and its closing quote are overwritten, so other tokens stay
+// valid.
+char *json_string_value(char *js, const json_token_t *token);
@@ -0,0 +1,65 @@
+// components/web_module/include/json_writer.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Streaming JSON writer. Output goes into a caller-provided buffer; when a
+// request is attached, a full buffer is sent as a chunk and reused, so
+// responses of any size need no heap.
+
+#define JSON_WRITER_MAX_DEPTH   8
+
+typedef struct {
+    httpd_req_t *req;           // NULL: buffer only
+    char *buf;
+    size_t size;
+    size_t len;
+    bool flushed;               // At least one chunk already sent
+    bool comma;                 // Next value needs a separating comma
+    uint8_t depth;
+    esp_err_t err;              // First error, sticky
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size, httpd_req_t *req);
+
+void json_obj_begin(json_writer_t *w);
+void json_obj_end(json_writer_t *w);
+void json_arr_begin(json_writer_t *w);
+void json_arr_end(json_writer_t *w);
+
+// Member key; must be followed by exactly one value
+void json_key(json_writer_t *w, const char *key);
+
+void json_str(json_writer_t *w, const char *value);
+void json_int(json_writer_t *w, int64_t value);
+void json_bool(json_writer_t *w, bool value);
+void json_null(json_writer_t *w);
+
+// Pre-encoded JSON value, copied verbatim
+void json_raw(json_writer_t *w, const char *json, size_t len);
+
+// Object member shorthands
+static inline void json_kv_str(json_writer_t *w, const char *key, const char *value) {
+    json_key(w, key);
+    json_str(w, value);
+}
+
+static inline void json_kv_int(json_writer_t *w, const char *key, int64_t value) {
+    json_key(w, key);
+    json_int(w, value);
+}
+
+static inline void json_kv_bool(json_writer_t *w, const char *key, bool value) {
+    json_key(w, key);
+    json_bool(w, value);
+}
+
+// Complete the document. With a request attached this sends it (a single
+// response if it fit in the buffer, otherwise the last chunk); without
+// one the buffer is NUL-terminated. Returns ESP_ERR_NO_MEM if a buffer-only
+// document was truncated, or the first send error.
+esp_err_t json_writer_finish(json_writer_t *w);
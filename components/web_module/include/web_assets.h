@@ -0,0 +1,24 @@
+// components/web_module/include/web_assets.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// One gzip-compressed UI file embedded in flash (table generated from www/
+// by gen_assets.py)
+typedef struct {
+    const char *uri;
+    const char *content_type;
+    const char *etag;           // Strong ETag, including the quotes
+    const char *cache_control;
+    const uint8_t *data;
+    const uint8_t *end;
+} web_asset_t;
+
+extern const web_asset_t web_assets[];
+extern const size_t web_assets_count;
+
+// Register a GET handler for every embedded asset
+esp_err_t web_assets_register(httpd_handle_t server);
@@ -0,0 +1,29 @@
+// components/web_module/include/web_auth.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Password verification for the auth challenge. Stored credentials are
+// SHA-256 digests (the SHA accelerator does the hashing through mbedTLS).
+// With CONFIG_WEB_AUTH_HASH_PBKDF2 each digest is additionally stretched
+// with PBKDF2-HMAC-SHA256 so every guess costs CONFIG_WEB_AUTH_PBKDF2_ITERATIONS
+// HMACs. Recent results, for unknown usernames as well as known ones, are
+// kept in a small LRU cache keyed by username and password digest.
+
+typedef struct {
+    const char *username;
+    const char *password_hash;  // SHA-256, hex
+    const char *role;
+} web_auth_user_t;
+
+// Derive the per-user verifiers. Must run before web_auth_verify.
+esp_err_t web_auth_init(void);
+
+// Check a login. Returns true and the user id on success. Unknown users
+// cost as much as wrong passwords, whether or not the attempt is cached.
+bool web_auth_verify(const char *username, const char *password, uint8_t *user);
+
+// User record by id, or NULL
+const web_auth_user_t *web_auth_user(uint8_t user);
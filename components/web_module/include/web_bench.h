@@ -0,0 +1,18 @@
+// components/web_module/include/web_bench.h
+#pragma once
+
+#include <stdint.h>
+
+// Parse a representative challenge body and build a typical response with
+// cJSON and with json_scan/json_writer, logging operations/s plus the peak
+// heap each approach used. Installs counting cJSON hooks for the duration,
+// so call it before anything else uses cJSON, i.e. before httpd_start.
+void web_json_benchmark(uint32_t iterations);
+
+// Hash a password-sized input with SHA-256 on the accelerator and in
+// software, then time full password verifications in the configured mode
+void web_hash_benchmark(uint32_t iterations);
+
+// Queries/s of the SQL challenge engine for an indexed lookup, a full scan
+// and an injected predicate
+void web_sql_benchmark(uint32_t iterations);
@@ -0,0 +1,16 @@
+// components/web_module/include/web_body.h
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Read the whole request body into the calling task's fixed arena and
+// NUL-terminate it. Never allocates; the buffer stays valid until the same
+// task reads the next body.
+//
+// On failure the error response has already been sent (413 for bodies over
+// CONFIG_WEB_BODY_MAX_LEN, 408 on timeout, 503 if no arena is free) and the
+// handler should return ESP_FAIL so the connection is closed rather than
+// drained.
+esp_err_t web_body_read(httpd_req_t *req, char **body, size_t *len);
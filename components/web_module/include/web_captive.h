@@ -0,0 +1,34 @@
+// components/web_module/include/web_captive.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Captive portal for the softAP: a DNS responder that resolves every name
+// to the AP, and the URIs phones and laptops probe after joining a network,
+// answered with a redirect to the challenge UI so the OS opens it straight
+// away.
+
+#define WEB_CAPTIVE_DNS_MAX_LEN 512     // Classic UDP DNS message limit
+
+typedef struct {
+    uint32_t dns_queries;       // Datagrams received
+    uint32_t dns_answers;       // A records handed out
+    uint32_t redirects;         // Probe URIs redirected to the portal
+} web_captive_stats_t;
+
+// Start the DNS task on CONFIG_WEB_CAPTIVE_DNS_PORT. addr is the IPv4
+// address (network byte order) every A query resolves to.
+esp_err_t web_captive_dns_start(uint32_t addr);
+
+// Turn the DNS query in pkt (len bytes, buffer of size cap) into its
+// response in place. Returns the response length, or 0 if nothing should
+// be sent back.
+size_t web_captive_dns_answer(uint8_t *pkt, size_t len, size_t cap, uint32_t addr);
+
+// Register the connectivity-check URIs
+esp_err_t web_captive_register(httpd_handle_t server);
+
+void web_captive_get_stats(web_captive_stats_t *stats);
@@ -9,6 +9,9 @@ typedef struct {
     bool completed;
     uint32_t attempts;
     uint32_t start_time;
+    uint32_t successes;
+    uint32_t bytes;             // Request body bytes received
+    uint32_t last_latency_us;   // Handler time of the latest attempt
 } challenge_status_t;
 
 // Challenge difficulty levels
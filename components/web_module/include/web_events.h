@@ -0,0 +1,15 @@
+// components/web_module/include/web_events.h
+#pragma once
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#define WEB_EVENTS_MAX_CLIENTS  8
+
+// Register the /events WebSocket and start the task that fans the shared
+// event stream out to every connected client. Each client has its own
+// cursor; one that cannot keep up skips events (reported in the "dropped"
+// field of its next frame) instead of slowing anyone else down, and one
+// whose socket stops taking frames is dropped after
+// CONFIG_WEB_WS_SEND_TIMEOUT_MS.
+esp_err_t web_events_start(httpd_handle_t server);
@@ -0,0 +1,41 @@
+// components/web_module/include/web_fb.h
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Mirror of a 128x64 monochrome framebuffer (SSD1306 layout: one byte per
+// column per 8-row page) streamed to browsers over the /fb WebSocket.
+//
+// Every binary frame is [flags][page mask] followed, for each page in the
+// mask from page 0 up, by that page's 128 bytes XORed with what the client
+// already has, run-length coded:
+//   0x00-0x7f n  literal: the next n+1 bytes
+//   0x80-0xff n  run: the next byte repeated (n & 0x7f)+1 times
+// WEB_FB_KEYFRAME in flags means the client's copy is all zeros first.
+// Unchanged stretches cost two bytes per 128, so a frame grows with what
+// changed rather than with the screen size.
+
+#define WEB_FB_WIDTH            128
+#define WEB_FB_PAGES            8
+#define WEB_FB_SIZE             (WEB_FB_WIDTH * WEB_FB_PAGES)
+#define WEB_FB_MAX_CLIENTS      4
+
+#define WEB_FB_KEYFRAME         0x01
+
+// Register /fb and start the task that sends updates
+esp_err_t web_fb_start(httpd_handle_t server);
+
+// Publish a new screen. Copies the dirty pages and wakes the sender, so it
+// is cheap enough to call from the display refresh (signature matches
+// ssd1306_refresh_cb_t).
+void web_fb_update(const uint8_t *fb, uint8_t dirty_pages, void *ctx);
+
+// Encode the pages in the mask of cur XOR base (base NULL: zeros) into a
+// frame. Returns the frame length; out must hold WEB_FB_FRAME_MAX bytes.
+size_t web_fb_encode(const uint8_t *base, const uint8_t *cur, uint8_t pages, uint8_t flags,
+                     uint8_t *out);
+
+// Literal headers cost at most one byte per 128 bytes of a page
+#define WEB_FB_FRAME_MAX        (2 + WEB_FB_PAGES * (WEB_FB_WIDTH + 1))
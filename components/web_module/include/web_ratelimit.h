@@ -0,0 +1,31 @@
+// components/web_module/include/web_ratelimit.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// Per-client token buckets, keyed by peer address and endpoint, in a fixed
+// table of WEB_RATELIMIT_SLOTS entries. Buckets refill lazily when they are
+// touched; a new client takes over the least recently used bucket in its
+// probe window, so every check is O(1) and memory is bounded.
+
+#define WEB_RATELIMIT_SLOTS     64      // Power of two
+
+typedef struct {
+    uint16_t per_minute;        // Sustained rate; 0 disables the limit
+    uint16_t burst;             // Bucket size
+} web_ratelimit_t;
+
+typedef struct {
+    uint32_t clients;           // Buckets in use
+    uint32_t evictions;         // Buckets taken over by another client
+} web_ratelimit_stats_t;
+
+// Take a token for this request's client at the given endpoint. Returns
+// false if the bucket is empty, with the seconds until the next token in
+// *retry_after_s.
+bool web_ratelimit_allow(httpd_req_t *req, uint8_t endpoint, const web_ratelimit_t *limit,
+                         uint32_t *retry_after_s);
+
+void web_ratelimit_get_stats(web_ratelimit_stats_t *out);
@@ -0,0 +1,30 @@
+// components/web_module/include/web_session.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Fixed-capacity session store. Sessions are random 128-bit tokens in an
+// open-addressing table of 2 * CONFIG_WEB_SESSION_MAX slots, so lookups
+// probe a short run whatever the number of sessions and nothing is
+// allocated. Expired sessions are removed when looked up and by a small
+// sweep on every login.
+
+#define WEB_SESSION_COOKIE      "sid"
+#define WEB_SESSION_TOKEN_LEN   32      // Hex characters
+
+// Start a session for a user and write its token (NUL-terminated hex)
+esp_err_t web_session_create(uint8_t user, char *token, size_t token_size);
+
+// Look up a hex token. Returns true with the user and remaining lifetime
+// if the session is live.
+bool web_session_lookup(const char *token, uint8_t *user, uint32_t *expires_in);
+
+// web_session_lookup on the request's session cookie
+bool web_session_check(httpd_req_t *req, uint8_t *user, uint32_t *expires_in);
+
+// Sessions in the table, including expired ones not yet removed
+size_t web_session_count(void);
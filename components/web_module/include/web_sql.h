@@ -0,0 +1,56 @@
+// components/web_module/include/web_sql.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Tiny query engine over an in-memory, column-per-array users table, so
+// injected predicates really change what the SQL injection challenge
+// returns. Supported grammar (keywords case-insensitive):
+//
+//   SELECT * | col [, col ...] FROM users [WHERE expr] [LIMIT n] [;]
+//   expr: expr OR expr | expr AND expr | NOT expr | ( expr )
+//       | operand (= | != | <> | < | <= | > | >=) operand
+//   operand: column | integer | 'string' ('' escapes a quote)
+//
+// "--" starts a comment that runs to the end of the query. Equality on id
+// or username anywhere in the top-level AND chain is answered from a hash
+// index; anything else scans the table. Parsing and evaluation use fixed
+// per-query buffers and never allocate.
+
+#define WEB_SQL_TABLE_ROWS      16
+#define WEB_SQL_MAX_COLUMNS     4
+
+typedef enum {
+    WEB_SQL_COL_ID,
+    WEB_SQL_COL_USERNAME,
+    WEB_SQL_COL_ROLE,
+    WEB_SQL_COL_EMAIL,
+} web_sql_column_t;
+
+typedef struct {
+    bool is_int;
+    int32_t i;
+    const char *s;
+} web_sql_value_t;
+
+typedef struct {
+    uint8_t columns[WEB_SQL_MAX_COLUMNS];   // Selected, in output order
+    uint8_t num_columns;
+    uint16_t rows[WEB_SQL_TABLE_ROWS];      // Matching row numbers
+    uint16_t num_rows;
+    bool used_index;
+    const char *error;                      // Static message, NULL on success
+    uint16_t error_pos;                     // Offset into the query
+} web_sql_result_t;
+
+// Build the hash indexes. Must run before web_sql_exec.
+esp_err_t web_sql_init(void);
+
+// Run a query. Returns ESP_ERR_INVALID_ARG with result->error set if it
+// does not parse.
+esp_err_t web_sql_exec(const char *query, web_sql_result_t *result);
+
+const char *web_sql_column_name(uint8_t column);
+web_sql_value_t web_sql_get(uint16_t row, uint8_t column);
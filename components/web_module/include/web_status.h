@@ -0,0 +1,21 @@
+// components/web_module/include/web_status.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "web_challenges.h"
+
+#define WEB_STATUS_MAX_CHALLENGES   8
+
+// Per-challenge counters behind a seqlock: writers (the request handlers)
+// serialize on a short spinlock, readers never lock and retry if a write
+// overlapped their copy, so polling /status does not slow the handlers.
+
+// Zero the counters of a challenge and set its start time
+void web_status_reset(uint8_t id, uint32_t start_time);
+
+// Account one attempt at a challenge
+void web_status_record(uint8_t id, bool success, uint32_t bytes, uint32_t latency_us);
+
+// Consistent snapshot of a challenge's counters
+bool web_status_read(uint8_t id, challenge_status_t *out);
@@ -0,0 +1,36 @@
+// components/web_module/include/web_template.h
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Templates are compiled from templates/*.html by gen_templates.py into
+// const part tables (see the generated web_templates.h for the template
+// objects and their slot indices).
+
+typedef enum {
+    TPL_PART_LITERAL,           // Static text, sent straight from flash
+    TPL_PART_ESCAPED,           // Slot value, HTML-escaped
+    TPL_PART_RAW,               // Slot value, sent as is
+} tpl_part_type_t;
+
+typedef struct {
+    uint8_t type;               // tpl_part_type_t
+    uint8_t slot;
+    uint16_t len;               // Literal length
+    const char *text;           // Literal text, NULL for slots
+} tpl_part_t;
+
+typedef struct {
+    const char *name;
+    const tpl_part_t *parts;
+    uint16_t num_parts;
+    uint8_t num_slots;
+} web_template_t;
+
+// Send a template as a chunked text/html response. values holds one
+// NUL-terminated string (or NULL for empty) per slot. Literals and raw
+// slots are sent without copying; escaped slots are escaped through a
+// small stack buffer.
+esp_err_t web_template_render(httpd_req_t *req, const web_template_t *tpl, const char *const *values);
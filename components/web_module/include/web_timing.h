@@ -0,0 +1,24 @@
+// components/web_module/include/web_timing.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Timing oracle for the remote timing-attack challenge. A guess is compared
+// with a fixed secret by one of two comparators inside a critical section,
+// and the comparison alone is timed with the CPU cycle counter.
+
+#define WEB_TIMING_MAX_GUESS    32      // Longest guess compared
+#define WEB_TIMING_MAX_BATCH    32      // Guesses per request
+
+typedef enum {
+    WEB_TIMING_LEAKY,           // Byte by byte, returns at the first mismatch
+    WEB_TIMING_CONSTANT,        // Always looks at every byte of the secret
+} web_timing_mode_t;
+
+// Compare a guess with the secret. Returns the cycles the comparison took
+// (nanoseconds on the host build).
+uint32_t web_timing_compare(const char *guess, web_timing_mode_t mode, bool *match);
+
+// Cycles per microsecond of the counter used by web_timing_compare
+uint32_t web_timing_cycles_per_us(void);
@@ -0,0 +1,40 @@
+// components/web_module/include/web_workers.h
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "web_ratelimit.h"
+
+#define WEB_WORKERS_MAX_ENDPOINTS   8
+
+typedef struct {
+    const char *uri;
+    uint8_t max_in_flight;      // Queued plus running requests allowed
+    uint8_t in_flight;
+    uint32_t served;
+    uint32_t rejected;          // 503 because of the endpoint limit or a full queue
+    uint32_t throttled;         // 429 because the client exceeded its rate
+    uint32_t queue_time_max_us;
+    uint64_t queue_time_total_us;
+} web_endpoint_stats_t;
+
+// Create the job queue and CONFIG_WEB_WORKER_COUNT worker tasks
+esp_err_t web_workers_start(void);
+
+// Register uri so that its handler runs on the worker pool instead of the
+// httpd task. Each client is held to rate_limit (429 beyond it). At most
+// max_in_flight requests to it are queued or running; further ones, and any
+// that find the queue full, get 503.
+esp_err_t web_workers_register(httpd_handle_t server, const httpd_uri_t *uri, uint8_t max_in_flight,
+                               const web_ratelimit_t *rate_limit);
+
+// Snapshot of per-endpoint counters. Returns the number written.
+size_t web_workers_get_stats(web_endpoint_stats_t *out, size_t max_out);
+
+// Deepest the job queue has been since start
+uint32_t web_workers_queue_high_water(void);
+
+// Least free stack, in bytes, any worker has had after a request; 0 until
+// one has been served
+uint32_t web_workers_stack_free_min(void);
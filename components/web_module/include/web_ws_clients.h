@@ -0,0 +1,57 @@
+// components/web_module/include/web_ws_clients.h
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "freertos/FreeRTOS.h"
+
+// Client table for the one-way WebSocket streams (/events, /fb). The
+// handler adds sockets; one sender task snapshots, sends and removes them.
+// Every add bumps the slot's generation, so the sender can tell a new or
+// reused slot from the client it served last time and keep its own
+// per-client state without another lock.
+
+#define WEB_WS_CLIENTS_MAX      8
+
+typedef struct {
+    int fd;                     // -1 when free
+    uint32_t gen;               // Bumped by every add
+} web_ws_slot_t;
+
+typedef struct {
+    httpd_handle_t server;
+    web_ws_slot_t slots[WEB_WS_CLIENTS_MAX];
+    uint8_t size;
+    portMUX_TYPE lock;
+} web_ws_clients_t;
+
+// Static initializer for the lock; web_ws_clients_init does the rest
+#define WEB_WS_CLIENTS_INITIALIZER  {.lock = portMUX_INITIALIZER_UNLOCKED}
+
+void web_ws_clients_init(web_ws_clients_t *c, httpd_handle_t server, uint8_t size);
+
+// Claim a slot for fd: the one it already holds, else a free one, and cap
+// its send time at CONFIG_WEB_WS_SEND_TIMEOUT_MS. Returns ESP_ERR_NO_MEM
+// when the table is full.
+esp_err_t web_ws_clients_add(web_ws_clients_t *c, int fd);
+
+// Snapshot slot i; false if it is free
+bool web_ws_clients_get(web_ws_clients_t *c, int i, web_ws_slot_t *slot);
+
+// Free slot i unless it changed hands since the snapshot
+void web_ws_clients_remove(web_ws_clients_t *c, int i, const web_ws_slot_t *slot);
+
+// False, with the slot freed, if the server no longer reports the socket
+// as a WebSocket. It is closed already and its fd may belong to another
+// connection by now, so it is not touched.
+bool web_ws_clients_alive(web_ws_clients_t *c, int i, const web_ws_slot_t *slot);
+
+// Send a frame to a snapshot, checking it is alive first. A failed send
+// frees the slot and closes the session.
+esp_err_t web_ws_clients_send(web_ws_clients_t *c, int i, const web_ws_slot_t *slot,
+                              httpd_ws_frame_t *frame);
+
+// Handler body for frames a one-way stream receives: read and discard
+esp_err_t web_ws_discard(httpd_req_t *req);
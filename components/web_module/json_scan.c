@@ -0,0 +1,253 @@
+// components/web_module/json_scan.c
+#include "json_scan.h"
+#include <stdbool.h>
+#include <string.h>
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_primitive_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.'
+        || c == 'E';
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Offset just past the closing quote of the string starting at js[pos] == '"'
+static int scan_string(const char *js, size_t len, size_t pos) {
+    for (size_t i = pos + 1; i < len; i++) {
+        char c = js[i];
+        if (c == '"') return i + 1;
+        if ((unsigned char)c < 0x20) return JSON_SCAN_ERR_INVALID;
+        if (c != '\\') continue;
+        if (++i >= len) return JSON_SCAN_ERR_INVALID;
+        switch (js[i]) {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                break;
+            case 'u':
+                if (i + 4 >= len) return JSON_SCAN_ERR_INVALID;
+                for (int k = 1; k <= 4; k++) {
+                    if (hex_value(js[i + k]) < 0) return JSON_SCAN_ERR_INVALID;
+                }
+                i += 4;
+                break;
+            default:
+                return JSON_SCAN_ERR_INVALID;
+        }
+    }
+    return JSON_SCAN_ERR_INVALID;
+}
+
+static bool primitive_valid(const char *js, size_t start, size_t end) {
+    size_t n = end - start;
+    if ((n == 4 && memcmp(js + start, "true", 4) == 0) ||
+        (n == 5 && memcmp(js + start, "false", 5) == 0) ||
+        (n == 4 && memcmp(js + start, "null", 4) == 0)) {
+        return true;
+    }
+    char c = js[start];
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+int json_tokenize(const char *js, size_t len, json_token_t *tokens, size_t max_tokens) {
+    if (len > UINT16_MAX) return JSON_SCAN_ERR_NOMEM;
+
+    // Indices of the open containers and what the grammar allows next
+    int parents[JSON_SCAN_MAX_DEPTH];
+    int depth = 0;
+    bool expect_value = true;
+    bool expect_key = false;
+    bool expect_colon = false;
+    bool done = false;
+    size_t count = 0;
+
+    for (size_t pos = 0; pos < len; ) {
+        char c = js[pos];
+        if (is_space(c)) {
+            pos++;
+            continue;
+        }
+        if (done) return JSON_SCAN_ERR_INVALID;
+
+        json_token_t *parent = depth ? &tokens[parents[depth - 1]] : NULL;
+        bool in_object = parent && parent->type == JSON_TOKEN_OBJECT;
+
+        if (c == '}' || c == ']') {
+            if (parent == NULL || in_object != (c == '}') || expect_colon) return JSON_SCAN_ERR_INVALID;
+            // A pending value is only fine in an empty container
+            if (expect_value && parent->size != 0) return JSON_SCAN_ERR_INVALID;
+            parent->end = ++pos;
+            depth--;
+            expect_value = false;
+            expect_key = false;
+            done = depth == 0;
+            continue;
+        }
+        if (c == ',') {
+            if (parent == NULL || expect_value || expect_colon) return JSON_SCAN_ERR_INVALID;
+            expect_value = true;
+            expect_key = in_object;
+            pos++;
+            continue;
+        }
+        if (c == ':') {
+            if (!expect_colon) return JSON_SCAN_ERR_INVALID;
+            expect_colon = false;
+            expect_value = true;
+            pos++;
+            continue;
+        }
+
+        // Start of a value or key
+        if (!expect_value || expect_colon) return JSON_SCAN_ERR_INVALID;
+        bool is_key = in_object && expect_key;
+        if (is_key && c != '"') return JSON_SCAN_ERR_INVALID;
+        if (count >= max_tokens) return JSON_SCAN_ERR_NOMEM;
+
+        json_token_t *tok = &tokens[count];
+        tok->depth = depth;
+        tok->size = 0;
+        tok->start = pos;
+
+        if (c == '{' || c == '[') {
+            if (depth == JSON_SCAN_MAX_DEPTH) return JSON_SCAN_ERR_DEPTH;
+            tok->type = c == '{' ? JSON_TOKEN_OBJECT : JSON_TOKEN_ARRAY;
+            pos++;
+        } else if (c == '"') {
+            int end = scan_string(js, len, pos);
+            if (end < 0) return end;
+            tok->type = JSON_TOKEN_STRING;
+            tok->start = pos + 1;
+            tok->end = end - 1;
+            pos = end;
+        } else if (is_primitive_char(c)) {
+            size_t end = pos;
+            while (end < len && is_primitive_char(js[end])) end++;
+            if (!primitive_valid(js, pos, end)) return JSON_SCAN_ERR_INVALID;
+            tok->type = JSON_TOKEN_PRIMITIVE;
+            tok->end = end;
+            pos = end;
+        } else {
+            return JSON_SCAN_ERR_INVALID;
+        }
+
+        // Objects count keys, arrays count elements
+        if (parent && (is_key || !in_object)) parent->size++;
+
+        if (is_key) {
+            expect_key = false;
+            expect_value = false;
+            expect_colon = true;
+        } else if (tok->type == JSON_TOKEN_OBJECT || tok->type == JSON_TOKEN_ARRAY) {
+            parents[depth++] = count;
+            expect_value = true;
+            expect_key = tok->type == JSON_TOKEN_OBJECT;
+        } else {
+            expect_value = false;
+            done = depth == 0;
+        }
+        count++;
+    }
+
+    if (depth != 0 || count == 0) return JSON_SCAN_ERR_INVALID;
+    return count;
+}
+
+const json_token_t *json_object_get(const char *js, const json_token_t *tokens, int count,
+                                    const char *key) {
+    if (count < 1 || tokens[0].type != JSON_TOKEN_OBJECT) return NULL;
+
+    size_t key_len = strlen(key);
+    int i = 1;
+    while (i + 1 < count) {
+        const json_token_t *k = &tokens[i];
+        const json_token_t *v = &tokens[i + 1];
+        if ((size_t)(k->end - k->start) == key_len && memcmp(js + k->start, key, key_len) == 0) {
+            return v;
+        }
+        // Skip the value and everything nested inside it
+        i += 2;
+        while (i < count && tokens[i].depth > 1) i++;
+    }
+    return NULL;
+}
+
+// Write code point cp as UTF-8 at out, returning the number of bytes
+static int put_utf8(char *out, uint32_t cp) {
+    if (cp < 0x80) {
+        out[0] = cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = 0xC0 | (cp >> 6);
+        out[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = 0xE0 | (cp >> 12);
+        out[1] = 0x80 | ((cp >> 6) & 0x3F);
+        out[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+    out[0] = 0xF0 | (cp >> 18);
+    out[1] = 0x80 | ((cp >> 12) & 0x3F);
+    out[2] = 0x80 | ((cp >> 6) & 0x3F);
+    out[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+static uint32_t read_hex4(const char *p) {
+    return (hex_value(p[0]) << 12) | (hex_value(p[1]) << 8) | (hex_value(p[2]) << 4) | hex_value(p[3]);
+}
+
+char *json_string_value(char *js, const json_token_t *token) {
+    if (token == NULL || token->type != JSON_TOKEN_STRING) return NULL;
+
+    // Escapes never expand, so the output can overwrite the input
+    char *out = js + token->start;
+    const char *in = out;
+    const char *end = js + token->end;
+    while (in < end) {
+        if (*in != '\\') {
+            *out++ = *in++;
+            continue;
+        }
+        in++;
+        switch (*in++) {
+            case '"':  *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/':  *out++ = '/'; break;
+            case 'b':  *out++ = '\b'; break;
+            case 'f':  *out++ = '\f'; break;
+            case 'n':  *out++ = '\n'; break;
+            case 'r':  *out++ = '\r'; break;
+            case 't':  *out++ = '\t'; break;
+            case 'u': {
+                uint32_t cp = read_hex4(in);
+                in += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate must be followed by an escaped low one
+                    if (end - in < 6 || in[0] != '\\' || in[1] != 'u') return NULL;
+                    uint32_t low = read_hex4(in + 2);
+                    if (low < 0xDC00 || low > 0xDFFF) return NULL;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    in += 6;
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return NULL;
+                }
+                out += put_utf8(out, cp);
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+    *out = '\0';
+    return js + token->start;
+}
@@ -0,0 +1,181 @@
+// components/web_module/json_writer.c
+#include "json_writer.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size, httpd_req_t *req) {
+    memset(w, 0, sizeof(*w));
+    w->req = req;
+    w->buf = buf;
+    w->size = size;
+}
+
+// Send the buffered bytes as a chunk (request attached) or record overflow
+static bool flush(json_writer_t *w) {
+    if (w->err != ESP_OK) return false;
+    if (w->req == NULL) {
+        w->err = ESP_ERR_NO_MEM;
+        return false;
+    }
+    if (w->len > 0) {
+        w->err = httpd_resp_send_chunk(w->req, w->buf, w->len);
+        w->flushed = true;
+        w->len = 0;
+    }
+    return w->err == ESP_OK;
+}
+
+static void put(json_writer_t *w, const char *data, size_t n) {
+    // Keep one byte for the terminating NUL in buffer-only mode
+    while (n > 0) {
+        size_t room = w->size - 1 - w->len;
+        if (room == 0) {
+            if (!flush(w)) return;
+            continue;
+        }
+        size_t take = n < room ? n : room;
+        memcpy(w->buf + w->len, data, take);
+        w->len += take;
+        data += take;
+        n -= take;
+    }
+}
+
+static inline void put_char(json_writer_t *w, char c) {
+    put(w, &c, 1);
+}
+
+static void begin_value(json_writer_t *w) {
+    if (w->comma) put_char(w, ',');
+    w->comma = true;
+}
+
+static void put_escaped(json_writer_t *w, const char *s) {
+    put_char(w, '"');
+    const char *run = s;
+    for (; *s; s++) {
+        unsigned char c = *s;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // Copy the clean run, then the escape
+        put(w, run, s - run);
+        run = s + 1;
+        switch (c) {
+            case '"':  put(w, "\\\"", 2); break;
+            case '\\': put(w, "\\\\", 2); break;
+            case '\n': put(w, "\\n", 2); break;
+            case '\r': put(w, "\\r", 2); break;
+            case '\t': put(w, "\\t", 2); break;
+            case '\b': put(w, "\\b", 2); break;
+            case '\f': put(w, "\\f", 2); break;
+            default: {
+                char esc[7];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                put(w, esc, 6);
+                break;
+            }
+        }
+    }
+    put(w, run, s - run);
+    put_char(w, '"');
+}
+
+static void open_container(json_writer_t *w, char c) {
+    begin_value(w);
+    if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+        w->err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    w->depth++;
+    put_char(w, c);
+    w->comma = false;
+}
+
+static void close_container(json_writer_t *w, char c) {
+    if (w->depth == 0) {
+        w->err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    w->depth--;
+    put_char(w, c);
+    w->comma = true;
+}
+
+void json_obj_begin(json_writer_t *w) {
+    open_container(w, '{');
+}
+
+void json_obj_end(json_writer_t *w) {
+    close_container(w, '}');
+}
+
+void json_arr_begin(json_writer_t *w) {
+    open_container(w, '[');
+}
+
+void json_arr_end(json_writer_t *w) {
+    close_container(w, ']');
+}
+
+void json_key(json_writer_t *w, const char *key) {
+    begin_value(w);
+    put_escaped(w, key);
+    put_char(w, ':');
+    w->comma = false;
+}
+
+void json_str(json_writer_t *w, const char *value) {
+    if (value == NULL) {
+        json_null(w);
+        return;
+    }
+    begin_value(w);
+    put_escaped(w, value);
+}
+
+void json_int(json_writer_t *w, int64_t value) {
+    char num[24];
+    int n = snprintf(num, sizeof(num), "%" PRId64, value);
+    begin_value(w);
+    put(w, num, n);
+}
+
+void json_bool(json_writer_t *w, bool value) {
+    begin_value(w);
+    if (value) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+void json_null(json_writer_t *w) {
+    begin_value(w);
+    put(w, "null", 4);
+}
+
+void json_raw(json_writer_t *w, const char *json, size_t len) {
+    begin_value(w);
+    put(w, json, len);
+}
+
+esp_err_t json_writer_finish(json_writer_t *w) {
+    if (w->err == ESP_OK && w->depth != 0) w->err = ESP_ERR_INVALID_STATE;
+
+    if (w->req == NULL) {
+        w->buf[w->len] = '\0';
+        return w->err;
+    }
+    if (w->err != ESP_OK) return w->err;
+
+    // Small documents go out with a Content-Length instead of chunked
+    if (!w->flushed) {
+        w->err = httpd_resp_send(w->req, w->buf, w->len);
+        return w->err;
+    }
+    if (flush(w)) {
+        w->err = httpd_resp_send_chunk(w->req, NULL, 0);
+    }
+    return w->err;
+}
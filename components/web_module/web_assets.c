@@ -0,0 +1,67 @@
+// components/web_module/web_assets.c
+#include "web_assets.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "web_assets";
+
+// Longest If-None-Match value we compare; longer lists just miss
+#define IF_NONE_MATCH_MAX_LEN   128
+
+// True if an If-None-Match list names the asset's ETag (or is "*").
+// Weak comparison, as RFC 9110 requires for If-None-Match.
+static bool etag_matches(const char *list, const char *etag) {
+    size_t etag_len = strlen(etag);
+    const char *p = list;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        if (*p == '*') return true;
+        if (strncmp(p, "W/", 2) == 0) p += 2;
+        if (strncmp(p, etag, etag_len) == 0 && (p[etag_len] == '\0' || p[etag_len] == ',' ||
+                                                 p[etag_len] == ' ')) {
+            return true;
+        }
+        while (*p && *p != ',') p++;
+    }
+    return false;
+}
+
+static esp_err_t asset_handler(httpd_req_t *req) {
+    const web_asset_t *asset = req->user_ctx;
+
+    httpd_resp_set_hdr(req, "ETag", asset->etag);
+    httpd_resp_set_hdr(req, "Cache-Control", asset->cache_control);
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+
+    char if_none_match[IF_NONE_MATCH_MAX_LEN];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match,
+                                    sizeof(if_none_match)) == ESP_OK &&
+        etag_matches(if_none_match, asset->etag)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // Every browser accepts gzip, so the compressed bytes are always sent
+    httpd_resp_set_type(req, asset->content_type);
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, (const char *)asset->data, asset->end - asset->data);
+}
+
+esp_err_t web_assets_register(httpd_handle_t server) {
+    for (size_t i = 0; i < web_assets_count; i++) {
+        httpd_uri_t uri = {
+            .uri = web_assets[i].uri,
+            .method = HTTP_GET,
+            .handler = asset_handler,
+            .user_ctx = (void *)&web_assets[i],
+        };
+        esp_err_t ret = httpd_register_uri_handler(server, &uri);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register %s: %s", web_assets[i].uri, esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG, "Serving %u embedded assets", (unsigned)web_assets_count);
+    return ESP_OK;
+}
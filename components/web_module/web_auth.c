@@ -0,0 +1,174 @@
+// components/web_module/web_auth.c
+#include "web_auth.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/pkcs5.h"
+#include <string.h>
+#include "sdkconfig.h"
+
+static const char *TAG = "web_auth";
+
+#define DIGEST_LEN  32
+
+// Simulated user database; the passwords are "password" and "user123"
+static const web_auth_user_t USERS[] = {
+    {"admin", "5e884898da28047151d0e56f8dc6292773603d0d6aabbdd62a11ef721d1542d8", "admin"},
+    {"user", "e606e38b0d8c19b24cf0ee3808183162ea7cd63ff7912dbb22b5e803286b4446", "user"}
+};
+#define NUM_USERS   (sizeof(USERS) / sizeof(USERS[0]))
+
+// What a password is checked against: the stored digest, or in PBKDF2 mode
+// the digest stretched with the username as salt
+static uint8_t verifiers[NUM_USERS][DIGEST_LEN];
+// Compared against when the username is unknown
+static const uint8_t dummy_verifier[DIGEST_LEN];
+
+#if CONFIG_WEB_AUTH_CACHE_SIZE > 0
+// Keyed by username and password digest together, so unknown usernames
+// are cached like known ones and never share an entry
+typedef struct {
+    uint8_t key[DIGEST_LEN];
+    uint32_t last_used;         // 0: empty
+    uint8_t user;
+    bool match;
+} cache_entry_t;
+
+static cache_entry_t cache[CONFIG_WEB_AUTH_CACHE_SIZE];
+static uint32_t cache_clock = 0;
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_hex(const char *hex, uint8_t *out, size_t len) {
+    if (strlen(hex) != 2 * len) return false;
+    for (size_t i = 0; i < len; i++) {
+        int hi = hex_value(hex[2 * i]), lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out[i] = hi << 4 | lo;
+    }
+    return true;
+}
+
+// Stretch a password digest; a no-op in plain SHA-256 mode
+static int stretch(const uint8_t *digest, const char *salt, uint8_t *out) {
+#if CONFIG_WEB_AUTH_HASH_PBKDF2
+    return mbedtls_pkcs5_pbkdf2_hmac_ext(MBEDTLS_MD_SHA256, digest, DIGEST_LEN,
+                                         (const unsigned char *)salt, strlen(salt),
+                                         CONFIG_WEB_AUTH_PBKDF2_ITERATIONS, DIGEST_LEN, out);
+#else
+    (void)salt;
+    memcpy(out, digest, DIGEST_LEN);
+    return 0;
+#endif
+}
+
+static bool digest_equal(const uint8_t *a, const uint8_t *b) {
+    uint8_t diff = 0;
+    for (int i = 0; i < DIGEST_LEN; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+#if CONFIG_WEB_AUTH_CACHE_SIZE > 0
+// SHA-256 over the username, its terminator and the password digest
+static int cache_key(const char *username, const uint8_t *digest, uint8_t *key) {
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    int ret = mbedtls_sha256_starts(&ctx, 0);
+    if (ret == 0) ret = mbedtls_sha256_update(&ctx, (const unsigned char *)username, strlen(username) + 1);
+    if (ret == 0) ret = mbedtls_sha256_update(&ctx, digest, DIGEST_LEN);
+    if (ret == 0) ret = mbedtls_sha256_finish(&ctx, key);
+    mbedtls_sha256_free(&ctx);
+    return ret;
+}
+
+static bool cache_get(const uint8_t *key, uint8_t *user, bool *match) {
+    bool hit = false;
+    taskENTER_CRITICAL(&cache_lock);
+    for (int i = 0; i < CONFIG_WEB_AUTH_CACHE_SIZE; i++) {
+        if (cache[i].last_used && digest_equal(cache[i].key, key)) {
+            cache[i].last_used = ++cache_clock;
+            *user = cache[i].user;
+            *match = cache[i].match;
+            hit = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&cache_lock);
+    return hit;
+}
+
+static void cache_put(const uint8_t *key, uint8_t user, bool match) {
+    taskENTER_CRITICAL(&cache_lock);
+    int victim = 0;
+    for (int i = 1; i < CONFIG_WEB_AUTH_CACHE_SIZE; i++) {
+        if (cache[i].last_used < cache[victim].last_used) victim = i;
+    }
+    memcpy(cache[victim].key, key, DIGEST_LEN);
+    cache[victim].user = user;
+    cache[victim].match = match;
+    cache[victim].last_used = ++cache_clock;
+    taskEXIT_CRITICAL(&cache_lock);
+}
+#endif
+
+esp_err_t web_auth_init(void) {
+    for (size_t i = 0; i < NUM_USERS; i++) {
+        uint8_t digest[DIGEST_LEN];
+        if (!parse_hex(USERS[i].password_hash, digest, DIGEST_LEN) ||
+            stretch(digest, USERS[i].username, verifiers[i]) != 0) {
+            ESP_LOGE(TAG, "Cannot derive verifier for %s", USERS[i].username);
+            return ESP_FAIL;
+        }
+    }
+#if CONFIG_WEB_AUTH_HASH_PBKDF2
+    ESP_LOGI(TAG, "Passwords verified with PBKDF2-HMAC-SHA256, %d iterations",
+             CONFIG_WEB_AUTH_PBKDF2_ITERATIONS);
+#endif
+    return ESP_OK;
+}
+
+bool web_auth_verify(const char *username, const char *password, uint8_t *user) {
+    size_t id;
+    for (id = 0; id < NUM_USERS; id++) {
+        if (strcmp(username, USERS[id].username) == 0) break;
+    }
+    bool known = id < NUM_USERS;
+
+    uint8_t digest[DIGEST_LEN];
+    if (mbedtls_sha256((const unsigned char *)password, strlen(password), digest, 0) != 0) return false;
+
+    bool match;
+#if CONFIG_WEB_AUTH_CACHE_SIZE > 0
+    // Known and unknown usernames take the same path, hit or miss
+    uint8_t key[DIGEST_LEN];
+    uint8_t cached_user;
+    if (cache_key(username, digest, key) != 0) return false;
+    if (cache_get(key, &cached_user, &match)) {
+        if (match) *user = cached_user;
+        return match;
+    }
+#endif
+
+    uint8_t stretched[DIGEST_LEN];
+    if (stretch(digest, known ? USERS[id].username : username, stretched) != 0) return false;
+    match = digest_equal(stretched, known ? verifiers[id] : dummy_verifier) && known;
+
+#if CONFIG_WEB_AUTH_CACHE_SIZE > 0
+    cache_put(key, known ? id : 0, match);
+#endif
+    if (match) *user = id;
+    return match;
+}
+
+const web_auth_user_t *web_auth_user(uint8_t user) {
+    return user < NUM_USERS ? &USERS[user] : NULL;
+}
@@ -0,0 +1,187 @@
+// components/web_module/web_bench.c
+#include "web_bench.h"
+#include "json_scan.h"
+#include "json_writer.h"
+#include "web_auth.h"
+#include "web_sql.h"
+#include "cJSON.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_ESP32 && CONFIG_MBEDTLS_HARDWARE_SHA
+#include "sha/sha_parallel_engine.h"
+#define HASH_BENCH_SOFTWARE 1
+#endif
+
+static const char *TAG = "web_bench";
+
+static const char SAMPLE_BODY[] =
+    "{\"username\":\"admin\",\"password\":\"pass\\u0077ord123\",\"remember\":true,"
+    "\"client\":{\"agent\":\"curl/8.5\",\"lang\":\"en\"}}";
+
+// cJSON allocation tracking; each block is prefixed with its size
+static size_t heap_current;
+static size_t heap_peak;
+
+static void *counting_malloc(size_t size) {
+    size_t *block = malloc(sizeof(size_t) + size);
+    if (block == NULL) return NULL;
+    *block = size;
+    heap_current += size;
+    if (heap_current > heap_peak) heap_peak = heap_current;
+    return block + 1;
+}
+
+static void counting_free(void *ptr) {
+    if (ptr == NULL) return;
+    size_t *block = (size_t *)ptr - 1;
+    heap_current -= *block;
+    free(block);
+}
+
+static void log_result(const char *name, uint32_t iterations, int64_t elapsed_us, size_t peak) {
+    ESP_LOGI(TAG, "%-11s %lu ops in %lld us: %.0f ops/s, peak heap %u bytes",
+             name, (unsigned long)iterations, (long long)elapsed_us,
+             elapsed_us > 0 ? iterations * 1e6 / elapsed_us : 0.0, (unsigned)peak);
+}
+
+void web_json_benchmark(uint32_t iterations) {
+    char buf[sizeof(SAMPLE_BODY)];
+    uint32_t ok = 0;
+
+    // cJSON: full DOM, then two lookups, as the handlers used to do
+    cJSON_Hooks hooks = {.malloc_fn = counting_malloc, .free_fn = counting_free};
+    cJSON_InitHooks(&hooks);
+    heap_current = heap_peak = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(buf, SAMPLE_BODY, sizeof(buf));
+        cJSON *root = cJSON_ParseWithLength(buf, sizeof(buf) - 1);
+        const cJSON *user = cJSON_GetObjectItem(root, "username");
+        const cJSON *pass = cJSON_GetObjectItem(root, "password");
+        ok += cJSON_IsString(user) && cJSON_IsString(pass);
+        cJSON_Delete(root);
+    }
+    log_result("cJSON parse", iterations, esp_timer_get_time() - start, heap_peak);
+
+    // cJSON response: object, two members, unformatted print
+    heap_current = heap_peak = 0;
+    size_t out_len = 0;
+    start = esp_timer_get_time();
+    for (uint32_t i = 0; i < iterations; i++) {
+        cJSON *resp = cJSON_CreateObject();
+        cJSON_AddStringToObject(resp, "query", "SELECT * FROM users WHERE id = 1 OR \"1\"=\"1\"");
+        cJSON_AddStringToObject(resp, "hint", "SQL injection detected!");
+        char *text = cJSON_PrintUnformatted(resp);
+        out_len += text ? strlen(text) : 0;
+        cJSON_free(text);
+        cJSON_Delete(resp);
+    }
+    log_result("cJSON print", iterations, esp_timer_get_time() - start, heap_peak);
+    cJSON_InitHooks(NULL);
+
+    // json_scan: tokens on the stack, strings unescaped in the buffer
+    start = esp_timer_get_time();
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(buf, SAMPLE_BODY, sizeof(buf));
+        json_token_t tokens[16];
+        int count = json_tokenize(buf, sizeof(buf) - 1, tokens, 16);
+        char *user = json_string_value(buf, json_object_get(buf, tokens, count, "username"));
+        char *pass = json_string_value(buf, json_object_get(buf, tokens, count, "password"));
+        ok += user != NULL && pass != NULL;
+    }
+    log_result("json_scan", iterations, esp_timer_get_time() - start, 0);
+
+    // json_writer: same document into a stack buffer
+    start = esp_timer_get_time();
+    for (uint32_t i = 0; i < iterations; i++) {
+        char out[128];
+        json_writer_t w;
+        json_writer_init(&w, out, sizeof(out), NULL);
+        json_obj_begin(&w);
+        json_kv_str(&w, "query", "SELECT * FROM users WHERE id = 1 OR \"1\"=\"1\"");
+        json_kv_str(&w, "hint", "SQL injection detected!");
+        json_obj_end(&w);
+        out_len -= json_writer_finish(&w) == ESP_OK ? w.len : 0;
+    }
+    log_result("json_writer", iterations, esp_timer_get_time() - start, 0);
+
+    if (ok != 2 * iterations) {
+        ESP_LOGW(TAG, "Only %lu of %lu parses succeeded", (unsigned long)ok, (unsigned long)(2 * iterations));
+    }
+    if (out_len != 0) {
+        ESP_LOGW(TAG, "cJSON and json_writer output lengths differ");
+    }
+}
+
+static int64_t time_sha256(uint32_t iterations) {
+    static const unsigned char password[] = "correct horse battery staple";
+    unsigned char digest[32];
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < iterations; i++) {
+        mbedtls_sha256(password, sizeof(password) - 1, digest, 0);
+    }
+    return esp_timer_get_time() - start;
+}
+
+void web_hash_benchmark(uint32_t iterations) {
+#if HASH_BENCH_SOFTWARE
+    log_result("SHA-256 hw", iterations, time_sha256(iterations), 0);
+
+    // mbedTLS falls back to its software SHA-256 while the engine is held
+    esp_sha_lock_engine(SHA2_256);
+    log_result("SHA-256 sw", iterations, time_sha256(iterations), 0);
+    esp_sha_unlock_engine(SHA2_256);
+#else
+    log_result("SHA-256", iterations, time_sha256(iterations), 0);
+#endif
+
+    // Distinct wrong passwords, so the verification cache never hits
+    uint32_t verifications = iterations;
+#if CONFIG_WEB_AUTH_HASH_PBKDF2
+    verifications = iterations / CONFIG_WEB_AUTH_PBKDF2_ITERATIONS + 1;
+#endif
+    uint8_t user;
+    char guess[16];
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < verifications; i++) {
+        snprintf(guess, sizeof(guess), "guess%lu", (unsigned long)i);
+        web_auth_verify("admin", guess, &user);
+    }
+    log_result("verify", verifications, esp_timer_get_time() - start, 0);
+
+    // Repeated login, answered from the cache
+    start = esp_timer_get_time();
+    for (uint32_t i = 0; i < verifications; i++) {
+        web_auth_verify("admin", "password", &user);
+    }
+    log_result("verify rpt", verifications, esp_timer_get_time() - start, 0);
+}
+
+void web_sql_benchmark(uint32_t iterations) {
+    static const struct {
+        const char *name;
+        const char *query;
+    } cases[] = {
+        {"SQL index", "SELECT id, username, email FROM users WHERE id = 7 AND role = 'user'"},
+        {"SQL scan", "SELECT * FROM users WHERE role <> 'user' OR email = 'none'"},
+        {"SQL inject", "SELECT id, username, email FROM users WHERE id = 1 OR '1'='1' AND role = 'user'"},
+    };
+
+    web_sql_result_t result;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint32_t rows = 0;
+        int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < iterations; i++) {
+            if (web_sql_exec(cases[c].query, &result) == ESP_OK) rows += result.num_rows;
+        }
+        log_result(cases[c].name, iterations, esp_timer_get_time() - start, 0);
+        if (rows == 0) {
+            ESP_LOGW(TAG, "%s returned no rows", cases[c].name);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+// components/web_module/web_body.c
+#include "web_body.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "web_body";
+
+#define WEB_BODY_RECV_RETRIES   3
+
+// One arena per handler task, claimed on first use and kept for the
+// lifetime of the task
+typedef struct {
+    TaskHandle_t owner;
+    char buf[CONFIG_WEB_BODY_MAX_LEN + 1];
+} body_arena_t;
+
+static body_arena_t arenas[CONFIG_WEB_BODY_ARENAS];
+static portMUX_TYPE arena_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static body_arena_t *task_arena(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    body_arena_t *found = NULL;
+
+    taskENTER_CRITICAL(&arena_lock);
+    for (int i = 0; i < CONFIG_WEB_BODY_ARENAS && found == NULL; i++) {
+        if (arenas[i].owner == self) found = &arenas[i];
+    }
+    for (int i = 0; i < CONFIG_WEB_BODY_ARENAS && found == NULL; i++) {
+        if (arenas[i].owner == NULL) {
+            arenas[i].owner = self;
+            found = &arenas[i];
+        }
+    }
+    taskEXIT_CRITICAL(&arena_lock);
+    return found;
+}
+
+static void send_error(httpd_req_t *req, const char *status, const char *message) {
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Connection", "close");
+    httpd_resp_sendstr(req, message);
+}
+
+esp_err_t web_body_read(httpd_req_t *req, char **body, size_t *len) {
+    if (req->content_len > CONFIG_WEB_BODY_MAX_LEN) {
+        ESP_LOGW(TAG, "Rejecting %u byte body on %s", (unsigned)req->content_len, req->uri);
+        send_error(req, "413 Content Too Large",
+                   "{\"status\":\"error\",\"message\":\"Request body too large\"}");
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    body_arena_t *arena = task_arena();
+    if (arena == NULL) {
+        ESP_LOGE(TAG, "No free body arena, raise CONFIG_WEB_BODY_ARENAS");
+        send_error(req, "503 Service Unavailable",
+                   "{\"status\":\"error\",\"message\":\"Server busy\"}");
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t received = 0;
+    int retries = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, arena->buf + received, req->content_len - received);
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT && ++retries <= WEB_BODY_RECV_RETRIES) {
+            continue;
+        }
+        if (ret <= 0) {
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, NULL);
+            }
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+
+    arena->buf[received] = '\0';
+    *body = arena->buf;
+    *len = received;
+    return ESP_OK;
+}
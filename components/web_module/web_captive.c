@@ -0,0 +1,209 @@
+// components/web_module/web_captive.c
+#include "web_captive.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+static const char *TAG = "web_captive";
+
+#define DNS_HEADER_LEN      12
+#define DNS_ANSWER_LEN      16      // Name pointer, type, class, TTL, length, address
+#define DNS_TYPE_A          1
+#define DNS_TYPE_ANY        255
+#define DNS_CLASS_IN        1
+#define DNS_CLASS_ANY       255
+#define DNS_RCODE_FORMERR   1
+#define DNS_RCODE_NOTIMP    4
+
+// Short, so names cached while on the lab network soon resolve normally
+// again once the client leaves
+#define DNS_TTL_S           10
+
+#define DNS_TASK_STACK_SIZE 3072
+
+// Only the DNS task writes the dns_* counters and only the httpd task
+// writes redirects, so plain 32-bit stores are enough
+static web_captive_stats_t stats;
+
+// The one receive and transmit buffer; queries are answered in place
+static uint8_t packet[WEB_CAPTIVE_DNS_MAX_LEN];
+static uint32_t answer_addr;
+
+static inline uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static inline void put16(uint8_t *p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v & 0xff;
+}
+
+// Header-only reply carrying an error code
+static size_t dns_error(uint8_t *pkt, uint8_t rcode) {
+    pkt[2] = 0x80 | (pkt[2] & 0x79);    // QR, keep opcode and RD
+    pkt[3] = rcode;
+    memset(pkt + 4, 0, DNS_HEADER_LEN - 4);
+    return DNS_HEADER_LEN;
+}
+
+size_t web_captive_dns_answer(uint8_t *pkt, size_t len, size_t cap, uint32_t addr) {
+    // Never answer responses, or anything too short to carry an id
+    if (len < DNS_HEADER_LEN || (pkt[2] & 0x80)) return 0;
+    if (((pkt[2] >> 3) & 0x0f) != 0) return dns_error(pkt, DNS_RCODE_NOTIMP);
+    if (get16(pkt + 4) != 1) return dns_error(pkt, DNS_RCODE_FORMERR);
+
+    // Walk the question name; compression is not allowed in a query
+    size_t pos = DNS_HEADER_LEN;
+    while (pos < len && pkt[pos] != 0) {
+        if (pkt[pos] > 63 || pos - DNS_HEADER_LEN + pkt[pos] + 1 > 255) {
+            return dns_error(pkt, DNS_RCODE_FORMERR);
+        }
+        pos += pkt[pos] + 1;
+    }
+    if (pos + 5 > len) return dns_error(pkt, DNS_RCODE_FORMERR);
+    uint16_t qtype = get16(pkt + pos + 1);
+    uint16_t qclass = get16(pkt + pos + 3);
+    size_t question_end = pos + 5;
+
+    // Everything else (AAAA, HTTPS, ...) gets an empty NOERROR answer, so
+    // clients fall back to the A record instead of waiting for a timeout
+    bool answer = (qtype == DNS_TYPE_A || qtype == DNS_TYPE_ANY) &&
+                  (qclass == DNS_CLASS_IN || qclass == DNS_CLASS_ANY);
+    if (answer && question_end + DNS_ANSWER_LEN > cap) return 0;
+
+    // Authoritative answer; authority and additional records (EDNS) dropped
+    pkt[2] = 0x84 | (pkt[2] & 0x01);
+    pkt[3] = 0;
+    put16(pkt + 6, answer);
+    put16(pkt + 8, 0);
+    put16(pkt + 10, 0);
+    if (!answer) return question_end;
+
+    uint8_t *rr = pkt + question_end;
+    put16(rr, 0xc000 | DNS_HEADER_LEN);     // Points at the question name
+    put16(rr + 2, DNS_TYPE_A);
+    put16(rr + 4, DNS_CLASS_IN);
+    put16(rr + 6, 0);
+    put16(rr + 8, DNS_TTL_S);
+    put16(rr + 10, 4);
+    memcpy(rr + 12, &addr, 4);
+    return question_end + DNS_ANSWER_LEN;
+}
+
+static void dns_task(void *arg) {
+    int sock = (int)(intptr_t)arg;
+    while (1) {
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(sock, packet, sizeof(packet), 0, (struct sockaddr *)&from, &from_len);
+        if (len < 0) {
+            ESP_LOGW(TAG, "DNS receive failed");
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+        stats.dns_queries++;
+
+        size_t out = web_captive_dns_answer(packet, len, sizeof(packet), answer_addr);
+        if (out == 0) continue;
+        if (packet[7] != 0) stats.dns_answers++;
+        sendto(sock, packet, out, 0, (struct sockaddr *)&from, from_len);
+    }
+}
+
+esp_err_t web_captive_dns_start(uint32_t addr) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return ESP_FAIL;
+    }
+
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_WEB_CAPTIVE_DNS_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) != 0) {
+        ESP_LOGE(TAG, "Failed to bind DNS port %d", CONFIG_WEB_CAPTIVE_DNS_PORT);
+        close(sock);
+        return ESP_FAIL;
+    }
+
+    answer_addr = addr;
+    if (xTaskCreate(dns_task, "captive_dns", DNS_TASK_STACK_SIZE, (void *)(intptr_t)sock, 5, NULL) != pdPASS) {
+        close(sock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Captive DNS answering on port %d", CONFIG_WEB_CAPTIVE_DNS_PORT);
+    return ESP_OK;
+}
+
+// Send the client to the portal on the address and port it reached us on;
+// the Host header is whatever check domain the OS probed
+static esp_err_t portal_redirect_handler(httpd_req_t *req) {
+    struct sockaddr_storage ss;
+    socklen_t ss_len = sizeof(ss);
+    uint8_t ip[4] = {192, 168, 4, 1};
+    uint16_t port = CONFIG_WEB_SERVER_PORT;
+    if (getsockname(httpd_req_to_sockfd(req), (struct sockaddr *)&ss, &ss_len) == 0) {
+        if (ss.ss_family == AF_INET) {
+            const struct sockaddr_in *in = (const struct sockaddr_in *)&ss;
+            memcpy(ip, &in->sin_addr, 4);
+        } else if (ss.ss_family == AF_INET6) {
+            // IPv4-mapped on a dual-stack listener
+            memcpy(ip, ((const struct sockaddr_in6 *)&ss)->sin6_addr.s6_addr + 12, 4);
+        }
+    }
+
+    // Must outlive the response, which references it
+    char location[sizeof("http://255.255.255.255:65535/")];
+    if (port == 80) {
+        snprintf(location, sizeof(location), "http://%u.%u.%u.%u/", ip[0], ip[1], ip[2], ip[3]);
+    } else {
+        snprintf(location, sizeof(location), "http://%u.%u.%u.%u:%u/", ip[0], ip[1], ip[2], ip[3], port);
+    }
+
+    stats.redirects++;
+    httpd_resp_set_status(req, "302 Found");
+    httpd_resp_set_hdr(req, "Location", location);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, NULL, 0);
+}
+
+// Android, Apple, Windows and Firefox connectivity checks. Any answer but
+// the expected one makes the OS show its sign-in prompt.
+static const char *const PROBE_URIS[] = {
+    "/generate_204",
+    "/gen_204",
+    "/hotspot-detect.html",
+    "/library/test/success.html",
+    "/connecttest.txt",
+    "/ncsi.txt",
+    "/canonical.html",
+    "/success.txt",
+};
+
+esp_err_t web_captive_register(httpd_handle_t server) {
+    for (size_t i = 0; i < sizeof(PROBE_URIS) / sizeof(PROBE_URIS[0]); i++) {
+        httpd_uri_t uri = {
+            .uri = PROBE_URIS[i],
+            .method = HTTP_GET,
+            .handler = portal_redirect_handler,
+        };
+        esp_err_t ret = httpd_register_uri_handler(server, &uri);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register %s: %s", PROBE_URIS[i], esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+void web_captive_get_stats(web_captive_stats_t *out) {
+    *out = stats;
+}
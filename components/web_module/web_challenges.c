@@ -1,11 +1,27 @@
 
 // components/web_module/web_challenges.c
 #include "web_challenges.h"
+#include "web_body.h"
+#include "json_scan.h"
+#include "json_writer.h"
+#include "web_templates.h"
+#include "web_assets.h"
+#include "web_workers.h"
+#include "web_status.h"
+#include "web_session.h"
+#include "web_auth.h"
+#include "web_sql.h"
+#include "web_timing.h"
+#include "web_captive.h"
+#include "web_events.h"
+#include "web_fb.h"
+#include "event_stream.h"
+#include "web_bench.h"
 #include "esp_log.h"
-#include "esp_wifi.h"
-#include "esp_event.h"
-#include "nvs_flash.h"
-#include "cJSON.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "web_challenges";
@@ -13,128 +29,312 @@ static const char *TAG = "web_challenges";
 // Web server handle
 static httpd_handle_t server = NULL;
 
+// Challenge ids, also the index into challenges[] and the status slots
+enum {
+    CHALLENGE_AUTH,
+    CHALLENGE_SQLI,
+    CHALLENGE_XSS,
+    CHALLENGE_TIMING,
+    NUM_CHALLENGES
+};
+
 // Challenge definitions
 typedef struct {
     const char *name;
     const char *description;
     challenge_difficulty_t difficulty;
     httpd_uri_t endpoint;
-    challenge_status_t status;
+    uint8_t max_in_flight;      // Concurrent requests allowed on the worker pool
+    web_ratelimit_t rate_limit; // Per client
 } challenge_def_t;
 
-// Simulated user database for authentication challenges
-typedef struct {
-    const char *username;
-    const char *password_hash;
-    const char *role;
-} user_entry_t;
-
-static const user_entry_t DEMO_USERS[] = {
-    {"admin", "5e884898da28047151d0e56f8dc6292773603d0d6aabbdd62a11ef721d1542d8", "admin"},
-    {"user", "e606e38b0d8c19b24cf0ee3808183162ea7cd63ff7912dbb22b5e803286b4446", "user"}
-};
+#define CHALLENGE_RATE_LIMIT {.per_minute = CONFIG_WEB_RATELIMIT_PER_MIN, .burst = CONFIG_WEB_RATELIMIT_BURST}
+
+#define BODY_MAX_TOKENS 16
+
+// Root object, two members and a full batch of guesses
+#define TIMING_MAX_TOKENS (WEB_TIMING_MAX_BATCH + 8)
+
+static const char *const CHALLENGE_KEYS[NUM_CHALLENGES] = {"auth", "sqli", "xss", "timing"};
+
+// Account a handled attempt in the challenge's status counters and the
+// live event stream
+static void record_attempt(uint8_t id, int64_t start_us, size_t len, bool success) {
+    uint32_t latency_us = esp_timer_get_time() - start_us;
+    web_status_record(id, success, len, latency_us);
+
+    char json[64];
+    int n = snprintf(json, sizeof(json), "{\"challenge\":\"%s\",\"ok\":%s,\"bytes\":%u,\"us\":%" PRIu32 "}",
+                     CHALLENGE_KEYS[id], success ? "true" : "false", (unsigned)len, latency_us);
+    event_stream_publish(EVENT_SRC_WEB, "attempt", json, n);
+}
+
+// Extract string members of a JSON object body, unescaped in place. Fails
+// if the body is not an object or any field is missing or not a string.
+static bool body_fields(char *buf, size_t len, const char *const *keys, char **values, size_t n) {
+    json_token_t tokens[BODY_MAX_TOKENS];
+    int count = json_tokenize(buf, len, tokens, BODY_MAX_TOKENS);
+    if (count < 0) return false;
+
+    for (size_t i = 0; i < n; i++) {
+        values[i] = json_string_value(buf, json_object_get(buf, tokens, count, keys[i]));
+        if (values[i] == NULL) return false;
+    }
+    return true;
+}
 
 // Authentication challenge handler
 static esp_err_t auth_challenge_handler(httpd_req_t *req) {
-    char *buf = malloc(req->content_len + 1);
-    size_t received = httpd_req_recv(req, buf, req->content_len);
-    buf[received] = '\0';
-
-    cJSON *root = cJSON_Parse(buf);
-    const char *username = cJSON_GetObjectItem(root, "username")->valuestring;
-    const char *password = cJSON_GetObjectItem(root, "password")->valuestring;
-
-    // For training purposes, we're using basic authentication
-    // In real applications, you'd use proper security measures
-    bool auth_success = false;
-    for (size_t i = 0; i < sizeof(DEMO_USERS)/sizeof(DEMO_USERS[0]); i++) {
-        if (strcmp(username, DEMO_USERS[i].username) == 0) {
-            // In real applications, never store or compare plain passwords
-            if (strcmp(password, "password123") == 0) {
-                auth_success = true;
-                break;
-            }
-        }
+    int64_t start = esp_timer_get_time();
+    char *buf;
+    size_t len;
+    if (web_body_read(req, &buf, &len) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    static const char *const keys[] = {"username", "password"};
+    char *fields[2];
+    if (!body_fields(buf, len, keys, fields, 2)) {
+        record_attempt(CHALLENGE_AUTH, start, len, false);
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected username and password");
     }
+    const char *username = fields[0];
+    const char *password = fields[1];
+
+    uint8_t user;
+    bool auth_success = web_auth_verify(username, password, &user);
 
-    const char *response;
+    // Must outlive the response, which references it
+    char cookie[sizeof(WEB_SESSION_COOKIE "=; Path=/; HttpOnly; SameSite=Strict") + WEB_SESSION_TOKEN_LEN];
     if (auth_success) {
-        response = "{\"status\":\"success\",\"message\":\"Authentication successful\"}";
-    } else {
-        response = "{\"status\":\"error\",\"message\":\"Invalid credentials\"}";
+        char token[WEB_SESSION_TOKEN_LEN + 1];
+        if (web_session_create(user, token, sizeof(token)) == ESP_OK) {
+            snprintf(cookie, sizeof(cookie), WEB_SESSION_COOKIE "=%s; Path=/; HttpOnly; SameSite=Strict", token);
+            httpd_resp_set_hdr(req, "Set-Cookie", cookie);
+        }
     }
 
+    char out[128];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out), req);
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, response, strlen(response));
 
-    free(buf);
-    cJSON_Delete(root);
-    return ESP_OK;
+    json_obj_begin(&w);
+    json_kv_str(&w, "status", auth_success ? "success" : "error");
+    json_kv_str(&w, "message", auth_success ? "Authentication successful" : "Invalid credentials");
+    if (auth_success) json_kv_str(&w, "role", web_auth_user(user)->role);
+    json_obj_end(&w);
+    esp_err_t ret = json_writer_finish(&w);
+
+    record_attempt(CHALLENGE_AUTH, start, len, auth_success);
+    return ret;
 }
 
 // SQL Injection challenge handler
 static esp_err_t sqli_challenge_handler(httpd_req_t *req) {
-    char *buf = malloc(req->content_len + 1);
-    size_t received = httpd_req_recv(req, buf, req->content_len);
-    buf[received] = '\0';
+    int64_t start = esp_timer_get_time();
+    char *buf;
+    size_t len;
+    if (web_body_read(req, &buf, &len) != ESP_OK) {
+        return ESP_FAIL;
+    }
 
-    cJSON *root = cJSON_Parse(buf);
-    const char *user_input = cJSON_GetObjectItem(root, "query")->valuestring;
+    static const char *const keys[] = {"query"};
+    char *user_input;
+    if (!body_fields(buf, len, keys, &user_input, 1)) {
+        record_attempt(CHALLENGE_SQLI, start, len, false);
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected query");
+    }
 
-    // Simulate vulnerable SQL query
-    // WARNING: This is intentionally vulnerable for training purposes
+    // WARNING: This is intentionally vulnerable for training purposes. The
+    // role filter hides the admin row unless the input rewrites the WHERE.
     char query[256];
-    snprintf(query, sizeof(query), "SELECT * FROM users WHERE id = %s", user_input);
+    int n = snprintf(query, sizeof(query),
+                     "SELECT id, username, email FROM users WHERE id = %s AND role = 'user'", user_input);
+    if (n < 0 || n >= (int)sizeof(query)) {
+        record_attempt(CHALLENGE_SQLI, start, len, false);
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Query too long");
+    }
 
-    // Demonstrate SQL injection vulnerability
-    bool injection_detected = strstr(user_input, "'") != NULL || 
-                            strstr(user_input, "\"") != NULL || 
-                            strstr(user_input, ";") != NULL;
+    web_sql_result_t result;
+    esp_err_t exec = web_sql_exec(query, &result);
 
-    cJSON *response = cJSON_CreateObject();
-    cJSON_AddStringToObject(response, "query", query);
-    if (injection_detected) {
-        cJSON_AddStringToObject(response, "hint", "SQL injection detected! Can you bypass the authentication?");
+    // Solved once the result shows a row the filter should have hidden
+    bool injection_detected = false;
+    for (uint16_t i = 0; i < result.num_rows; i++) {
+        injection_detected |= strcmp(web_sql_get(result.rows[i], WEB_SQL_COL_ROLE).s, "user") != 0;
     }
 
-    char *resp_str = cJSON_Print(response);
+    char out[384];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out), req);
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, resp_str, strlen(resp_str));
 
-    free(buf);
-    free(resp_str);
-    cJSON_Delete(root);
-    cJSON_Delete(response);
-    return ESP_OK;
+    json_obj_begin(&w);
+    json_kv_str(&w, "query", query);
+    if (exec != ESP_OK) {
+        // Verbose errors are part of the lesson
+        json_kv_str(&w, "error", result.error);
+        json_kv_int(&w, "position", result.error_pos);
+    } else {
+        json_key(&w, "rows");
+        json_arr_begin(&w);
+        for (uint16_t i = 0; i < result.num_rows; i++) {
+            json_obj_begin(&w);
+            for (uint8_t c = 0; c < result.num_columns; c++) {
+                web_sql_value_t v = web_sql_get(result.rows[i], result.columns[c]);
+                json_key(&w, web_sql_column_name(result.columns[c]));
+                if (v.is_int) {
+                    json_int(&w, v.i);
+                } else {
+                    json_str(&w, v.s);
+                }
+            }
+            json_obj_end(&w);
+        }
+        json_arr_end(&w);
+        json_kv_bool(&w, "indexed", result.used_index);
+    }
+    if (injection_detected) {
+        json_kv_str(&w, "hint", "SQL injection detected! You read rows the filter was hiding.");
+    }
+    json_obj_end(&w);
+    esp_err_t ret = json_writer_finish(&w);
+
+    record_attempt(CHALLENGE_SQLI, start, len, injection_detected);
+    return ret;
 }
 
 // XSS challenge handler
 static esp_err_t xss_challenge_handler(httpd_req_t *req) {
-    char *buf = malloc(req->content_len + 1);
-    size_t received = httpd_req_recv(req, buf, req->content_len);
-    buf[received] = '\0';
+    int64_t start = esp_timer_get_time();
+    char *buf;
+    size_t len;
+    if (web_body_read(req, &buf, &len) != ESP_OK) {
+        return ESP_FAIL;
+    }
 
-    cJSON *root = cJSON_Parse(buf);
-    const char *user_input = cJSON_GetObjectItem(root, "message")->valuestring;
+    static const char *const keys[] = {"message"};
+    char *user_input;
+    if (!body_fields(buf, len, keys, &user_input, 1)) {
+        record_attempt(CHALLENGE_XSS, start, len, false);
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected message");
+    }
 
-    // Intentionally vulnerable HTML response
+    // Intentionally vulnerable HTML response: the message slot is raw
+    // ({{!message}} in templates/guestbook.html)
     // WARNING: This is for training purposes only
-    char response[512];
-    snprintf(response, sizeof(response),
-             "<html><body><h1>Guest Book</h1><p>Latest message: %s</p></body></html>",
-             user_input);
+    const char *values[TPL_GUESTBOOK_NUM_SLOTS] = {
+        [TPL_GUESTBOOK_TITLE] = "XSS Attack",
+        [TPL_GUESTBOOK_MESSAGE] = user_input,
+    };
+    // Markup in the message means it was injected into the page
+    bool injected = strchr(user_input, '<') != NULL;
+    esp_err_t ret = web_template_render(req, &tpl_guestbook, values);
+
+    record_attempt(CHALLENGE_XSS, start, len, injected);
+    return ret;
+}
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, response, strlen(response));
+// Timing attack challenge handler. Accepts {"guess": "..."} or
+// {"guesses": ["...", ...]} with an optional "mode" of "leaky" (default)
+// or "constant". Every guess is compared before anything is sent, and the
+// per-guess cycle counts come back in the body and a Server-Timing header,
+// so the measurement carries no network jitter.
+static esp_err_t timing_challenge_handler(httpd_req_t *req) {
+    int64_t start = esp_timer_get_time();
+    char *buf;
+    size_t len;
+    if (web_body_read(req, &buf, &len) != ESP_OK) {
+        return ESP_FAIL;
+    }
 
-    free(buf);
-    cJSON_Delete(root);
-    return ESP_OK;
+    json_token_t tokens[TIMING_MAX_TOKENS];
+    int count = json_tokenize(buf, len, tokens, TIMING_MAX_TOKENS);
+    const json_token_t *batch = NULL;
+    const json_token_t *single = NULL;
+    const json_token_t *mode_token = NULL;
+    if (count > 0) {
+        batch = json_object_get(buf, tokens, count, "guesses");
+        single = json_object_get(buf, tokens, count, "guess");
+        mode_token = json_object_get(buf, tokens, count, "mode");
+    }
+
+    web_timing_mode_t mode = WEB_TIMING_LEAKY;
+    if (mode_token != NULL) {
+        const char *name = json_string_value(buf, mode_token);
+        if (name != NULL && strcmp(name, "constant") == 0) {
+            mode = WEB_TIMING_CONSTANT;
+        } else if (name == NULL || strcmp(name, "leaky") != 0) {
+            record_attempt(CHALLENGE_TIMING, start, len, false);
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Mode must be leaky or constant");
+        }
+    }
+
+    // Strings have no child tokens, so a batch's elements follow its array
+    const json_token_t *first = single;
+    size_t num_guesses = single != NULL;
+    if (batch != NULL && batch->type == JSON_TOKEN_ARRAY) {
+        first = batch + 1;
+        num_guesses = batch->size;
+    }
+    bool valid = num_guesses > 0 && num_guesses <= WEB_TIMING_MAX_BATCH;
+    char *guesses[WEB_TIMING_MAX_BATCH];
+    for (size_t i = 0; valid && i < num_guesses; i++) {
+        guesses[i] = json_string_value(buf, &first[i]);
+        valid = guesses[i] != NULL && strlen(guesses[i]) <= WEB_TIMING_MAX_GUESS;
+    }
+    if (!valid) {
+        record_attempt(CHALLENGE_TIMING, start, len, false);
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST,
+                                   "Expected guess or up to 32 guesses of at most 32 characters");
+    }
+
+    uint32_t cycles[WEB_TIMING_MAX_BATCH];
+    uint32_t matches = 0;   // Bit per guess
+    uint64_t total = 0;
+    for (size_t i = 0; i < num_guesses; i++) {
+        bool match;
+        cycles[i] = web_timing_compare(guesses[i], mode, &match);
+        matches |= (uint32_t)match << i;
+        total += cycles[i];
+    }
+
+    // Must outlive the response, which references it
+    char server_timing[80];
+    uint64_t total_ns = total * 1000 / web_timing_cycles_per_us();
+    snprintf(server_timing, sizeof(server_timing),
+             "compare;dur=%" PRIu32 ".%06" PRIu32 ";desc=\"%u guesses, %" PRIu64 " cycles\"",
+             (uint32_t)(total_ns / 1000000), (uint32_t)(total_ns % 1000000), (unsigned)num_guesses, total);
+    httpd_resp_set_hdr(req, "Server-Timing", server_timing);
+
+    char out[256];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out), req);
+    httpd_resp_set_type(req, "application/json");
+
+    json_obj_begin(&w);
+    json_kv_str(&w, "mode", mode == WEB_TIMING_CONSTANT ? "constant" : "leaky");
+    json_kv_int(&w, "cycles_per_us", web_timing_cycles_per_us());
+    json_key(&w, "results");
+    json_arr_begin(&w);
+    for (size_t i = 0; i < num_guesses; i++) {
+        json_obj_begin(&w);
+        json_kv_int(&w, "cycles", cycles[i]);
+        json_kv_bool(&w, "match", matches & (1u << i));
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    esp_err_t ret = json_writer_finish(&w);
+
+    record_attempt(CHALLENGE_TIMING, start, len, matches != 0);
+    return ret;
 }
 
 // Challenge definitions array
-static challenge_def_t challenges[] = {
-    {
+static challenge_def_t challenges[NUM_CHALLENGES] = {
+    [CHALLENGE_AUTH] = {
         .name = "Basic Authentication",
         .description = "Learn about authentication vulnerabilities",
         .difficulty = DIFFICULTY_EASY,
@@ -142,9 +342,12 @@ static challenge_def_t challenges[] = {
             .uri = "/auth",
             .method = HTTP_POST,
             .handler = auth_challenge_handler
-        }
+        },
+        .max_in_flight = 2,
+        // Brute-forcing is part of the lesson, but must not starve the class
+        .rate_limit = {.per_minute = CONFIG_WEB_RATELIMIT_AUTH_PER_MIN, .burst = CONFIG_WEB_RATELIMIT_AUTH_BURST}
     },
-    {
+    [CHALLENGE_SQLI] = {
         .name = "SQL Injection",
         .description = "Practice SQL injection detection and prevention",
         .difficulty = DIFFICULTY_MEDIUM,
@@ -152,9 +355,11 @@ static challenge_def_t challenges[] = {
             .uri = "/query",
             .method = HTTP_POST,
             .handler = sqli_challenge_handler
-        }
+        },
+        .max_in_flight = 3,
+        .rate_limit = CHALLENGE_RATE_LIMIT
     },
-    {
+    [CHALLENGE_XSS] = {
         .name = "XSS Attack",
         .description = "Learn about Cross-Site Scripting vulnerabilities",
         .difficulty = DIFFICULTY_MEDIUM,
@@ -162,46 +367,253 @@ static challenge_def_t challenges[] = {
             .uri = "/message",
             .method = HTTP_POST,
             .handler = xss_challenge_handler
-        }
+        },
+        .max_in_flight = 3,
+        .rate_limit = CHALLENGE_RATE_LIMIT
+    },
+    [CHALLENGE_TIMING] = {
+        .name = "Timing Attack",
+        .description = "Recover a secret from how long a comparison takes",
+        .difficulty = DIFFICULTY_HARD,
+        .endpoint = {
+            .uri = "/timing",
+            .method = HTTP_POST,
+            .handler = timing_challenge_handler
+        },
+        .max_in_flight = 3,
+        .rate_limit = CHALLENGE_RATE_LIMIT
     }
 };
 
+// Challenge counters, worker pool and heap state as JSON. Runs on the httpd
+// task; reading the counters never blocks the handlers.
+static esp_err_t status_handler(httpd_req_t *req) {
+    char out[256];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out), req);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    json_obj_begin(&w);
+    json_kv_int(&w, "uptime_s", esp_timer_get_time() / 1000000);
+    json_kv_int(&w, "sessions", web_session_count());
+
+    json_key(&w, "heap");
+    json_obj_begin(&w);
+    json_kv_int(&w, "free", heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+    json_kv_int(&w, "min_free", heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT));
+    json_kv_int(&w, "largest_block", heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT));
+    json_obj_end(&w);
+
+    json_key(&w, "challenges");
+    json_arr_begin(&w);
+    for (uint8_t i = 0; i < NUM_CHALLENGES; i++) {
+        challenge_status_t status;
+        web_status_read(i, &status);
+        json_obj_begin(&w);
+        json_kv_int(&w, "id", i);
+        json_kv_str(&w, "name", challenges[i].name);
+        json_kv_bool(&w, "completed", status.completed);
+        json_kv_int(&w, "attempts", status.attempts);
+        json_kv_int(&w, "successes", status.successes);
+        json_kv_int(&w, "bytes", status.bytes);
+        json_kv_int(&w, "last_latency_us", status.last_latency_us);
+        json_kv_int(&w, "start_time", status.start_time);
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+
+    web_endpoint_stats_t endpoints[WEB_WORKERS_MAX_ENDPOINTS];
+    size_t n = web_workers_get_stats(endpoints, WEB_WORKERS_MAX_ENDPOINTS);
+    json_key(&w, "workers");
+    json_obj_begin(&w);
+    json_kv_int(&w, "queue_high_water", web_workers_queue_high_water());
+    json_kv_int(&w, "stack_free_min", web_workers_stack_free_min());
+    json_key(&w, "endpoints");
+    json_arr_begin(&w);
+    for (size_t i = 0; i < n; i++) {
+        json_obj_begin(&w);
+        json_kv_str(&w, "uri", endpoints[i].uri);
+        json_kv_int(&w, "in_flight", endpoints[i].in_flight);
+        json_kv_int(&w, "served", endpoints[i].served);
+        json_kv_int(&w, "rejected", endpoints[i].rejected);
+        json_kv_int(&w, "throttled", endpoints[i].throttled);
+        json_kv_int(&w, "queue_avg_us", endpoints[i].served ?
+                    endpoints[i].queue_time_total_us / endpoints[i].served : 0);
+        json_kv_int(&w, "queue_max_us", endpoints[i].queue_time_max_us);
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+
+    web_ratelimit_stats_t limits;
+    web_ratelimit_get_stats(&limits);
+    json_key(&w, "rate_limit");
+    json_obj_begin(&w);
+    json_kv_int(&w, "clients", limits.clients);
+    json_kv_int(&w, "evictions", limits.evictions);
+    json_obj_end(&w);
+
+    web_captive_stats_t captive;
+    web_captive_get_stats(&captive);
+    json_key(&w, "captive");
+    json_obj_begin(&w);
+    json_kv_int(&w, "dns_queries", captive.dns_queries);
+    json_kv_int(&w, "dns_answers", captive.dns_answers);
+    json_kv_int(&w, "redirects", captive.redirects);
+    json_obj_end(&w);
+
+    json_obj_end(&w);
+    return json_writer_finish(&w);
+}
+
+// Identity behind the session cookie; the base for challenges that build
+// on a logged-in user
+static esp_err_t whoami_handler(httpd_req_t *req) {
+    uint8_t user;
+    uint32_t expires_in;
+    if (!web_session_check(req, &user, &expires_in)) {
+        httpd_resp_set_status(req, "401 Unauthorized");
+        httpd_resp_set_type(req, "application/json");
+        return httpd_resp_sendstr(req, "{\"status\":\"error\",\"message\":\"Not logged in\"}");
+    }
+
+    char out[96];
+    json_writer_t w;
+    json_writer_init(&w, out, sizeof(out), req);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    json_obj_begin(&w);
+    const web_auth_user_t *account = web_auth_user(user);
+    json_kv_str(&w, "user", account->username);
+    json_kv_str(&w, "role", account->role);
+    json_kv_int(&w, "expires_in", expires_in);
+    json_obj_end(&w);
+    return json_writer_finish(&w);
+}
+
+static const httpd_uri_t whoami_uri = {
+    .uri = "/whoami",
+    .method = HTTP_GET,
+    .handler = whoami_handler
+};
+
+static const httpd_uri_t status_uri = {
+    .uri = "/status",
+    .method = HTTP_GET,
+    .handler = status_handler
+};
+
 esp_err_t web_challenges_init(void) {
+    esp_err_t ret;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = CONFIG_WEB_SERVER_PORT;
     config.stack_size = 8192;
+    config.max_uri_handlers = 24;
+    // Room for a full softAP (10 stations); the oldest idle connection is
+    // closed when a new client arrives and all sockets are in use
+    config.max_open_sockets = 12;
+    config.lru_purge_enable = true;
+
+    ret = web_auth_init();
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
-    esp_err_t ret = httpd_start(&server, &config);
+    ret = web_sql_init();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = web_workers_start();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+#if CONFIG_WEB_JSON_BENCHMARK
+    // Installs global cJSON hooks while it runs
+    web_json_benchmark(10000);
+#endif
+
+    ret = httpd_start(&server, &config);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start web server!");
         return ret;
     }
 
-    // Register all challenge endpoints
-    for (size_t i = 0; i < sizeof(challenges)/sizeof(challenges[0]); i++) {
-        httpd_register_uri_handler(server, &challenges[i].endpoint);
+    // Register all challenge endpoints; they run on the worker pool
+    for (size_t i = 0; i < NUM_CHALLENGES; i++) {
+        ret = web_workers_register(server, &challenges[i].endpoint, challenges[i].max_in_flight,
+                                   &challenges[i].rate_limit);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register %s", challenges[i].endpoint.uri);
+            return ret;
+        }
+    }
+
+    ret = httpd_register_uri_handler(server, &status_uri);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = httpd_register_uri_handler(server, &whoami_uri);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Challenge UI at "/"
+    ret = web_assets_register(server);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // OS connectivity checks redirect to the UI
+    ret = web_captive_register(server);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Live telemetry for the UI at "/events"
+    ret = web_events_start(server);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start event stream");
+        return ret;
     }
 
+    // Device screen mirror at "/fb", fed through web_fb_update
+    ret = web_fb_start(server);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start framebuffer stream");
+        return ret;
+    }
+
+#if CONFIG_WEB_HASH_BENCHMARK
+    web_hash_benchmark(2000);
+#endif
+#if CONFIG_WEB_SQL_BENCHMARK
+    web_sql_benchmark(10000);
+#endif
+
     ESP_LOGI(TAG, "Web challenges server started");
     return ESP_OK;
 }
 
 esp_err_t start_challenge(uint8_t challenge_id) {
-    if (challenge_id >= sizeof(challenges)/sizeof(challenges[0])) {
+    if (challenge_id >= NUM_CHALLENGES) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    challenges[challenge_id].status.start_time = esp_timer_get_time() / 1000000;
-    challenges[challenge_id].status.attempts = 0;
-    challenges[challenge_id].status.completed = false;
+    web_status_reset(challenge_id, esp_timer_get_time() / 1000000);
 
     ESP_LOGI(TAG, "Started challenge: %s", challenges[challenge_id].name);
     return ESP_OK;
 }
 
 challenge_status_t get_challenge_status(uint8_t challenge_id) {
-    if (challenge_id >= sizeof(challenges)/sizeof(challenges[0])) {
-        challenge_status_t empty_status = {0};
-        return empty_status;
+    challenge_status_t status = {0};
+    if (challenge_id < NUM_CHALLENGES) {
+        web_status_read(challenge_id, &status);
     }
-    return challenges[challenge_id].status;
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+// components/web_module/web_events.c
+#include "web_events.h"
+#include "event_stream.h"
+#include "json_writer.h"
+#include "web_ws_clients.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "web_events";
+
+#define WEB_EVENTS_FRAME_MAX        1400    // One TCP segment
+#define WEB_EVENTS_BACKLOG          16      // Recent events sent on connect
+#define WEB_EVENTS_TASK_STACK       4096
+#define WEB_EVENTS_TASK_PRIORITY    4
+// Worst-case bytes for one event besides its payload, plus the frame trailer
+#define WEB_EVENTS_ENVELOPE_MAX     128
+
+// Per-client state, owned by the broadcaster task
+typedef struct {
+    uint32_t gen;               // Client slot generation this state is for
+    uint32_t cursor;
+    uint32_t dropped;           // Skipped events not reported yet
+} ws_client_t;
+
+static TaskHandle_t broadcaster = NULL;
+static web_ws_clients_t clients = WEB_WS_CLIENTS_INITIALIZER;
+static ws_client_t states[WEB_EVENTS_MAX_CLIENTS];
+
+_Static_assert(WEB_EVENTS_MAX_CLIENTS <= WEB_WS_CLIENTS_MAX, "Client table too small");
+
+static esp_err_t events_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        // Handshake done; start streaming to this socket
+        int fd = httpd_req_to_sockfd(req);
+        if (web_ws_clients_add(&clients, fd) != ESP_OK) {
+            ESP_LOGW(TAG, "Event stream full, refusing client %d", fd);
+            return ESP_FAIL;
+        }
+        if (broadcaster) xTaskNotifyGive(broadcaster);
+        return ESP_OK;
+    }
+
+    // The stream is one-way
+    return web_ws_discard(req);
+}
+
+// Pack as many pending events as fit into one text frame. Returns the
+// frame length, 0 if the client is up to date.
+static size_t build_frame(ws_client_t *client, char *buf, size_t size, bool *more) {
+    json_writer_t w;
+    json_writer_init(&w, buf, size, NULL);
+    json_obj_begin(&w);
+    json_key(&w, "events");
+    json_arr_begin(&w);
+
+    event_t ev;
+    size_t count = 0;
+    *more = false;
+    while (true) {
+        if (!event_stream_read(&client->cursor, &ev, &client->dropped)) break;
+        if (w.size - w.len < ev.len + WEB_EVENTS_ENVELOPE_MAX) {
+            // Leave it for the next frame
+            client->cursor = ev.seq;
+            *more = true;
+            break;
+        }
+        json_obj_begin(&w);
+        json_kv_int(&w, "seq", ev.seq);
+        json_kv_int(&w, "t", ev.timestamp_ms);
+        json_kv_str(&w, "src", event_stream_source_name(ev.source));
+        json_kv_str(&w, "type", ev.type);
+        json_key(&w, "data");
+        json_raw(&w, ev.payload, ev.len);
+        json_obj_end(&w);
+        count++;
+    }
+
+    json_arr_end(&w);
+    json_kv_int(&w, "dropped", client->dropped);
+    json_obj_end(&w);
+    if ((count == 0 && client->dropped == 0) || json_writer_finish(&w) != ESP_OK) return 0;
+    client->dropped = 0;
+    return w.len;
+}
+
+static void broadcaster_task(void *pvParameters) {
+    static char frame_buf[WEB_EVENTS_FRAME_MAX];
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        bool any_more = false;
+        for (int i = 0; i < WEB_EVENTS_MAX_CLIENTS; i++) {
+            web_ws_slot_t slot;
+            if (!web_ws_clients_get(&clients, i, &slot) || !web_ws_clients_alive(&clients, i, &slot)) {
+                continue;
+            }
+
+            // A new client starts with the recent backlog
+            ws_client_t *client = &states[i];
+            if (client->gen != slot.gen) {
+                uint32_t head = event_stream_head();
+                uint32_t start = head > WEB_EVENTS_BACKLOG ? head - WEB_EVENTS_BACKLOG : 0;
+                *client = (ws_client_t){.gen = slot.gen, .cursor = start};
+            }
+
+            bool more;
+            size_t len = build_frame(client, frame_buf, sizeof(frame_buf), &more);
+            any_more |= more;
+            if (len == 0) continue;
+            httpd_ws_frame_t frame = {
+                .final = true,
+                .type = HTTPD_WS_TYPE_TEXT,
+                .payload = (uint8_t *)frame_buf,
+                .len = len,
+            };
+            if (web_ws_clients_send(&clients, i, &slot, &frame) != ESP_OK) {
+                ESP_LOGW(TAG, "Dropping event client %d", slot.fd);
+            }
+        }
+
+        if (any_more) xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    }
+}
+
+esp_err_t web_events_start(httpd_handle_t server) {
+    web_ws_clients_init(&clients, server, WEB_EVENTS_MAX_CLIENTS);
+
+    static const httpd_uri_t events_uri = {
+        .uri = "/events",
+        .method = HTTP_GET,
+        .handler = events_handler,
+        .is_websocket = true,
+    };
+    esp_err_t ret = httpd_register_uri_handler(server, &events_uri);
+    if (ret != ESP_OK) return ret;
+
+    if (xTaskCreate(broadcaster_task, "web_events", WEB_EVENTS_TASK_STACK, NULL,
+                    WEB_EVENTS_TASK_PRIORITY, &broadcaster) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    event_stream_set_consumer(broadcaster);
+    return ESP_OK;
+}
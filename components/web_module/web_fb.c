@@ -0,0 +1,187 @@
+// components/web_module/web_fb.c
+#include "web_fb.h"
+#include "web_ws_clients.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "web_fb";
+
+#define WEB_FB_TASK_STACK       3072
+#define WEB_FB_TASK_PRIORITY    3
+#define RLE_MAX                 128     // Longest literal or run per token
+#define RLE_MIN_RUN             3       // Shorter repeats stay in a literal
+
+static TaskHandle_t sender = NULL;
+static web_ws_clients_t clients = WEB_WS_CLIENTS_INITIALIZER;
+// Slot generation each client was last sent a keyframe for; only the
+// sender task touches it
+static uint32_t synced_gen[WEB_FB_MAX_CLIENTS];
+
+_Static_assert(WEB_FB_MAX_CLIENTS <= WEB_WS_CLIENTS_MAX, "Client table too small");
+
+// Latest screen and the pages changed since the sender last looked,
+// written by web_fb_update
+static uint8_t latest[WEB_FB_SIZE];
+static uint8_t latest_dirty;
+static portMUX_TYPE fb_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Screen every synced client holds; only the sender task touches it
+static uint8_t sent[WEB_FB_SIZE];
+
+// Length of the run of equal bytes starting at d[0]
+static size_t run_length(const uint8_t *d, size_t n) {
+    size_t r = 1;
+    while (r < n && r < RLE_MAX && d[r] == d[0]) r++;
+    return r;
+}
+
+static size_t encode_page(const uint8_t *d, uint8_t *out) {
+    size_t o = 0, i = 0;
+    while (i < WEB_FB_WIDTH) {
+        size_t run = run_length(d + i, WEB_FB_WIDTH - i);
+        if (run >= RLE_MIN_RUN) {
+            out[o++] = 0x80 | (run - 1);
+            out[o++] = d[i];
+            i += run;
+            continue;
+        }
+
+        // Literal up to the next worthwhile run
+        size_t start = i;
+        while (i < WEB_FB_WIDTH && i - start < RLE_MAX &&
+               run_length(d + i, WEB_FB_WIDTH - i) < RLE_MIN_RUN) {
+            i++;
+        }
+        out[o++] = i - start - 1;
+        memcpy(out + o, d + start, i - start);
+        o += i - start;
+    }
+    return o;
+}
+
+size_t web_fb_encode(const uint8_t *base, const uint8_t *cur, uint8_t pages, uint8_t flags,
+                     uint8_t *out) {
+    size_t o = 0;
+    out[o++] = flags;
+    out[o++] = pages;
+    for (int p = 0; p < WEB_FB_PAGES; p++) {
+        if (!(pages & (1 << p))) continue;
+
+        uint8_t delta[WEB_FB_WIDTH];
+        const uint8_t *page = cur + p * WEB_FB_WIDTH;
+        for (int x = 0; x < WEB_FB_WIDTH; x++) {
+            delta[x] = base ? page[x] ^ base[p * WEB_FB_WIDTH + x] : page[x];
+        }
+        o += encode_page(delta, out + o);
+    }
+    return o;
+}
+
+void web_fb_update(const uint8_t *fb, uint8_t dirty_pages, void *ctx) {
+    (void)ctx;
+    taskENTER_CRITICAL(&fb_lock);
+    for (int p = 0; p < WEB_FB_PAGES; p++) {
+        if (dirty_pages & (1 << p)) {
+            memcpy(latest + p * WEB_FB_WIDTH, fb + p * WEB_FB_WIDTH, WEB_FB_WIDTH);
+        }
+    }
+    latest_dirty |= dirty_pages;
+    taskEXIT_CRITICAL(&fb_lock);
+
+    if (sender) xTaskNotifyGive(sender);
+}
+
+static esp_err_t fb_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        // Synced by the sender with a keyframe
+        int fd = httpd_req_to_sockfd(req);
+        if (web_ws_clients_add(&clients, fd) != ESP_OK) {
+            ESP_LOGW(TAG, "Framebuffer stream full, refusing client %d", fd);
+            return ESP_FAIL;
+        }
+        if (sender) xTaskNotifyGive(sender);
+        return ESP_OK;
+    }
+
+    // The stream is one-way
+    return web_ws_discard(req);
+}
+
+// Send to slot i if it holds a client in the wanted sync state. One that
+// gets a keyframe is synced from then on.
+static void send_to(int i, bool synced, const uint8_t *data, size_t len) {
+    web_ws_slot_t slot;
+    if (!web_ws_clients_get(&clients, i, &slot) || (synced_gen[i] == slot.gen) != synced) return;
+
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = (uint8_t *)data,
+        .len = len,
+    };
+    esp_err_t ret = web_ws_clients_send(&clients, i, &slot, &frame);
+    if (ret == ESP_OK) {
+        synced_gen[i] = slot.gen;
+    } else if (ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "Dropping framebuffer client %d", slot.fd);
+    }
+}
+
+static void sender_task(void *pvParameters) {
+    static uint8_t next[WEB_FB_SIZE];
+    static uint8_t frame[WEB_FB_FRAME_MAX];
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Several refreshes since the last pass collapse into one update
+        taskENTER_CRITICAL(&fb_lock);
+        uint8_t dirty = latest_dirty;
+        latest_dirty = 0;
+        memcpy(next, latest, sizeof(next));
+        taskEXIT_CRITICAL(&fb_lock);
+
+        // Synced clients get the delta from sent[]
+        if (dirty) {
+            size_t len = web_fb_encode(sent, next, dirty, 0, frame);
+            for (int i = 0; i < WEB_FB_MAX_CLIENTS; i++) {
+                send_to(i, true, frame, len);
+            }
+            memcpy(sent, next, sizeof(sent));
+        }
+
+        // New clients join with the whole screen
+        bool joining = false;
+        for (int i = 0; i < WEB_FB_MAX_CLIENTS; i++) {
+            web_ws_slot_t slot;
+            joining |= web_ws_clients_get(&clients, i, &slot) && synced_gen[i] != slot.gen;
+        }
+        if (joining) {
+            size_t len = web_fb_encode(NULL, sent, (1 << WEB_FB_PAGES) - 1, WEB_FB_KEYFRAME, frame);
+            for (int i = 0; i < WEB_FB_MAX_CLIENTS; i++) {
+                send_to(i, false, frame, len);
+            }
+        }
+    }
+}
+
+esp_err_t web_fb_start(httpd_handle_t server) {
+    web_ws_clients_init(&clients, server, WEB_FB_MAX_CLIENTS);
+
+    static const httpd_uri_t fb_uri = {
+        .uri = "/fb",
+        .method = HTTP_GET,
+        .handler = fb_handler,
+        .is_websocket = true,
+    };
+    esp_err_t ret = httpd_register_uri_handler(server, &fb_uri);
+    if (ret != ESP_OK) return ret;
+
+    if (xTaskCreate(sender_task, "web_fb", WEB_FB_TASK_STACK, NULL,
+                    WEB_FB_TASK_PRIORITY, &sender) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,121 @@
+// components/web_module/web_ratelimit.c
+#include "web_ratelimit.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+_Static_assert((WEB_RATELIMIT_SLOTS & (WEB_RATELIMIT_SLOTS - 1)) == 0,
+               "WEB_RATELIMIT_SLOTS must be a power of two");
+
+#define PROBE_WINDOW        4
+// Tokens are kept in 1/60000ths, so a bucket gains exactly per_minute
+// units per millisecond and no fraction is lost between checks
+#define TOKEN               60000u
+
+typedef struct {
+    uint8_t addr[16];           // IPv6, or IPv4-mapped
+    uint32_t tokens;            // In 1/TOKEN of a token
+    uint32_t last_ms;           // Last refill, also the LRU stamp
+    uint8_t endpoint;
+    bool used;
+} bucket_t;
+
+static bucket_t buckets[WEB_RATELIMIT_SLOTS];
+static web_ratelimit_stats_t stats;
+static portMUX_TYPE bucket_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Peer address as 16 bytes; false if the socket has no peer
+static bool peer_addr(httpd_req_t *req, uint8_t *addr) {
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr *)&ss, &len) != 0) return false;
+
+    memset(addr, 0, 16);
+    if (ss.ss_family == AF_INET) {
+        const struct sockaddr_in *in = (const struct sockaddr_in *)&ss;
+        addr[10] = addr[11] = 0xff;
+        memcpy(addr + 12, &in->sin_addr, 4);
+        return true;
+    }
+    if (ss.ss_family == AF_INET6) {
+        memcpy(addr, &((const struct sockaddr_in6 *)&ss)->sin6_addr, 16);
+        return true;
+    }
+    return false;
+}
+
+static uint32_t bucket_hash(const uint8_t *addr, uint8_t endpoint) {
+    uint32_t h = 2166136261u ^ endpoint;
+    for (int i = 0; i < 16; i++) {
+        h = (h ^ addr[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Existing bucket for the key, or the one to (re)use: a free slot in the
+// window, else its least recently used
+static bucket_t *find_bucket(const uint8_t *addr, uint8_t endpoint, bool *found) {
+    uint32_t start = bucket_hash(addr, endpoint);
+    bucket_t *victim = NULL;
+    for (int i = 0; i < PROBE_WINDOW; i++) {
+        bucket_t *b = &buckets[(start + i) & (WEB_RATELIMIT_SLOTS - 1)];
+        if (b->used && b->endpoint == endpoint && memcmp(b->addr, addr, 16) == 0) {
+            *found = true;
+            return b;
+        }
+        if (victim == NULL || (victim->used && (!b->used || (int32_t)(b->last_ms - victim->last_ms) < 0))) {
+            victim = b;
+        }
+    }
+    *found = false;
+    return victim;
+}
+
+bool web_ratelimit_allow(httpd_req_t *req, uint8_t endpoint, const web_ratelimit_t *limit,
+                         uint32_t *retry_after_s) {
+    if (limit->per_minute == 0) return true;
+
+    uint8_t addr[16];
+    if (!peer_addr(req, addr)) return true;
+
+    uint32_t now = esp_timer_get_time() / 1000;
+    uint32_t capacity = limit->burst * TOKEN;   // Fits: 65535 * 60000 < 2^32
+    bool allowed;
+
+    taskENTER_CRITICAL(&bucket_lock);
+    bool found;
+    bucket_t *b = find_bucket(addr, endpoint, &found);
+    if (!found) {
+        if (b->used) {
+            stats.evictions++;
+        } else {
+            stats.clients++;
+        }
+        memcpy(b->addr, addr, 16);
+        b->endpoint = endpoint;
+        b->tokens = capacity;
+        b->used = true;
+    } else {
+        uint64_t refill = (uint64_t)(now - b->last_ms) * limit->per_minute;
+        b->tokens = refill >= capacity - b->tokens ? capacity : b->tokens + refill;
+    }
+    b->last_ms = now;
+
+    allowed = b->tokens >= TOKEN;
+    if (allowed) {
+        b->tokens -= TOKEN;
+    } else {
+        uint32_t missing_ms = (TOKEN - b->tokens + limit->per_minute - 1) / limit->per_minute;
+        *retry_after_s = missing_ms < 1000 ? 1 : (missing_ms + 999) / 1000;
+    }
+    taskEXIT_CRITICAL(&bucket_lock);
+    return allowed;
+}
+
+void web_ratelimit_get_stats(web_ratelimit_stats_t *out) {
+    taskENTER_CRITICAL(&bucket_lock);
+    *out = stats;
+    taskEXIT_CRITICAL(&bucket_lock);
+}
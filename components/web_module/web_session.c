@@ -0,0 +1,187 @@
+// components/web_module/web_session.c
+#include "web_session.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <sys/random.h>
+#else
+#include "esp_random.h"
+#endif
+
+#define SESSION_TOKEN_BYTES     (WEB_SESSION_TOKEN_LEN / 2)
+// Load factor stays at or below one half, so probe runs are short and
+// every probe loop reaches an empty slot
+#define SESSION_SLOTS           (2 * CONFIG_WEB_SESSION_MAX)
+#define SESSION_SWEEP_STEP      2
+
+typedef struct {
+    uint8_t token[SESSION_TOKEN_BYTES];
+    uint32_t expires;           // Seconds since boot
+    uint8_t user;
+    bool used;
+} session_slot_t;
+
+static session_slot_t slots[SESSION_SLOTS];
+static size_t count = 0;
+static size_t sweep_cursor = 0;
+static portMUX_TYPE session_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t now_s(void) {
+    return esp_timer_get_time() / 1000000;
+}
+
+static void fill_random(uint8_t *buf, size_t len) {
+#if CONFIG_IDF_TARGET_LINUX
+    while (getrandom(buf, len, 0) != (ssize_t)len) {
+    }
+#else
+    esp_fill_random(buf, len);
+#endif
+}
+
+// Tokens are uniformly random, so their first bytes are already a hash
+static size_t home_slot(const uint8_t *token) {
+    uint32_t h;
+    memcpy(&h, token, sizeof(h));
+    return h % SESSION_SLOTS;
+}
+
+// Constant time, so response timing does not leak matching prefixes
+static bool token_equal(const uint8_t *a, const uint8_t *b) {
+    uint8_t diff = 0;
+    for (int i = 0; i < SESSION_TOKEN_BYTES; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+static bool expired(const session_slot_t *slot, uint32_t now) {
+    return (int32_t)(slot->expires - now) <= 0;
+}
+
+// Delete by shifting later members of the probe run back, so the table
+// never accumulates tombstones
+static void remove_slot(size_t i) {
+    size_t j = i;
+    while (1) {
+        j = (j + 1) % SESSION_SLOTS;
+        if (!slots[j].used) break;
+        size_t k = home_slot(slots[j].token);
+        // Leave the entry if its home lies cyclically in (i, j]
+        bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if (stays) continue;
+        slots[i] = slots[j];
+        i = j;
+    }
+    slots[i].used = false;
+    count--;
+}
+
+// Check a few slots per call so expired sessions do not pile up
+static void sweep(uint32_t now, size_t steps) {
+    while (steps-- > 0 && count > 0) {
+        if (slots[sweep_cursor].used && expired(&slots[sweep_cursor], now)) {
+            // A shifted entry may now occupy this slot; check it next time
+            remove_slot(sweep_cursor);
+        } else {
+            sweep_cursor = (sweep_cursor + 1) % SESSION_SLOTS;
+        }
+    }
+}
+
+// Make room when the table is full: drop expired sessions, then the one
+// closest to expiry. Only runs at capacity, so the O(n) scan is bounded.
+static void evict(uint32_t now) {
+    sweep(now, SESSION_SLOTS);
+    if (count < CONFIG_WEB_SESSION_MAX) return;
+
+    size_t victim = 0;
+    for (size_t i = 0; i < SESSION_SLOTS; i++) {
+        if (!slots[i].used) continue;
+        if (!slots[victim].used || (int32_t)(slots[i].expires - slots[victim].expires) < 0) {
+            victim = i;
+        }
+    }
+    remove_slot(victim);
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_token(const char *hex, uint8_t *token) {
+    if (strlen(hex) != WEB_SESSION_TOKEN_LEN) return false;
+    for (int i = 0; i < SESSION_TOKEN_BYTES; i++) {
+        int hi = hex_value(hex[2 * i]), lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        token[i] = hi << 4 | lo;
+    }
+    return true;
+}
+
+esp_err_t web_session_create(uint8_t user, char *token, size_t token_size) {
+    if (token_size < WEB_SESSION_TOKEN_LEN + 1) return ESP_ERR_INVALID_SIZE;
+
+    session_slot_t entry = {.user = user, .used = true};
+    fill_random(entry.token, SESSION_TOKEN_BYTES);
+    uint32_t now = now_s();
+    entry.expires = now + CONFIG_WEB_SESSION_TTL;
+
+    taskENTER_CRITICAL(&session_lock);
+    sweep(now, SESSION_SWEEP_STEP);
+    if (count >= CONFIG_WEB_SESSION_MAX) evict(now);
+    size_t i = home_slot(entry.token);
+    while (slots[i].used) {
+        i = (i + 1) % SESSION_SLOTS;
+    }
+    slots[i] = entry;
+    count++;
+    taskEXIT_CRITICAL(&session_lock);
+
+    for (int b = 0; b < SESSION_TOKEN_BYTES; b++) {
+        snprintf(token + 2 * b, 3, "%02x", entry.token[b]);
+    }
+    return ESP_OK;
+}
+
+bool web_session_lookup(const char *hex, uint8_t *user, uint32_t *expires_in) {
+    uint8_t token[SESSION_TOKEN_BYTES];
+    if (!parse_token(hex, token)) return false;
+
+    bool found = false;
+    uint32_t now = now_s();
+    taskENTER_CRITICAL(&session_lock);
+    for (size_t i = home_slot(token); slots[i].used; i = (i + 1) % SESSION_SLOTS) {
+        if (!token_equal(slots[i].token, token)) continue;
+        if (expired(&slots[i], now)) {
+            remove_slot(i);
+        } else {
+            found = true;
+            if (user) *user = slots[i].user;
+            if (expires_in) *expires_in = slots[i].expires - now;
+        }
+        break;
+    }
+    taskEXIT_CRITICAL(&session_lock);
+    return found;
+}
+
+bool web_session_check(httpd_req_t *req, uint8_t *user, uint32_t *expires_in) {
+    char token[WEB_SESSION_TOKEN_LEN + 1];
+    size_t len = sizeof(token);
+    if (httpd_req_get_cookie_val(req, WEB_SESSION_COOKIE, token, &len) != ESP_OK) return false;
+    return web_session_lookup(token, user, expires_in);
+}
+
+size_t web_session_count(void) {
+    taskENTER_CRITICAL(&session_lock);
+    size_t n = count;
+    taskEXIT_CRITICAL(&session_lock);
+    return n;
+}
@@ -0,0 +1,513 @@
+// components/web_module/web_sql.c
+#include "web_sql.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define SQL_MAX_NODES       32
+#define SQL_MAX_DEPTH       8
+#define SQL_POOL_SIZE       128     // Unescaped string literals of one query
+#define INDEX_SLOTS         (2 * WEB_SQL_TABLE_ROWS)
+
+_Static_assert((INDEX_SLOTS & (INDEX_SLOTS - 1)) == 0, "INDEX_SLOTS must be a power of two");
+
+// The users table, one array per column
+static int32_t col_id[WEB_SQL_TABLE_ROWS] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+static const char *col_username[WEB_SQL_TABLE_ROWS] = {
+    "admin", "alice", "bob", "carol", "dave", "erin", "frank", "grace",
+    "heidi", "ivan", "judy", "mallory", "niaj", "olivia", "peggy", "trent"
+};
+static const char *col_role[WEB_SQL_TABLE_ROWS] = {
+    "admin", "user", "user", "user", "user", "user", "user", "user",
+    "user", "user", "user", "user", "user", "user", "user", "auditor"
+};
+static const char *col_email[WEB_SQL_TABLE_ROWS] = {
+    "flag{or_1_equals_1}@lab.local", "alice@lab.local", "bob@lab.local",
+    "carol@lab.local", "dave@lab.local", "erin@lab.local", "frank@lab.local",
+    "grace@lab.local", "heidi@lab.local", "ivan@lab.local", "judy@lab.local",
+    "mallory@lab.local", "niaj@lab.local", "olivia@lab.local", "peggy@lab.local",
+    "trent@lab.local"
+};
+
+static const char *const COLUMN_NAMES[WEB_SQL_MAX_COLUMNS] = {"id", "username", "role", "email"};
+
+// Open-addressing indexes holding row + 1 (0: empty slot)
+static uint8_t id_index[INDEX_SLOTS];
+static uint8_t username_index[INDEX_SLOTS];
+
+typedef enum {
+    TOK_END,
+    TOK_IDENT,
+    TOK_INT,
+    TOK_STRING,
+    TOK_STAR,
+    TOK_COMMA,
+    TOK_LPAREN,
+    TOK_RPAREN,
+    TOK_SEMI,
+    TOK_EQ,
+    TOK_NE,
+    TOK_LT,
+    TOK_LE,
+    TOK_GT,
+    TOK_GE,
+} tok_type_t;
+
+typedef enum {
+    NODE_COLUMN,
+    NODE_INT,
+    NODE_STRING,
+    NODE_CMP,
+    NODE_AND,
+    NODE_OR,
+    NODE_NOT,
+} node_type_t;
+
+typedef struct {
+    uint8_t type;               // node_type_t
+    uint8_t op;                 // tok_type_t of a comparison
+    int8_t left, right;         // Child nodes
+    int32_t value;              // Integer, or column number
+    const char *str;            // String literal in the pool
+} node_t;
+
+typedef struct {
+    const char *src;
+    size_t pos;
+    // Current token
+    uint8_t tok;
+    size_t tok_start;
+    size_t tok_len;
+    int32_t tok_int;
+    const char *tok_str;
+    // Per-query storage
+    node_t nodes[SQL_MAX_NODES];
+    int num_nodes;
+    char pool[SQL_POOL_SIZE];
+    size_t pool_len;
+    const char *error;
+    size_t error_pos;
+} parser_t;
+
+static uint32_t hash_int(int32_t v) {
+    return (uint32_t)v * 2654435761u;
+}
+
+static uint32_t hash_str(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static void index_insert(uint8_t *index, uint32_t hash, uint16_t row) {
+    uint32_t i = hash & (INDEX_SLOTS - 1);
+    while (index[i]) {
+        i = (i + 1) & (INDEX_SLOTS - 1);
+    }
+    index[i] = row + 1;
+}
+
+esp_err_t web_sql_init(void) {
+    memset(id_index, 0, sizeof(id_index));
+    memset(username_index, 0, sizeof(username_index));
+    for (uint16_t row = 0; row < WEB_SQL_TABLE_ROWS; row++) {
+        index_insert(id_index, hash_int(col_id[row]), row);
+        index_insert(username_index, hash_str(col_username[row]), row);
+    }
+    return ESP_OK;
+}
+
+// Row with the given id, or -1
+static int lookup_id(int32_t id) {
+    for (uint32_t i = hash_int(id) & (INDEX_SLOTS - 1); id_index[i]; i = (i + 1) & (INDEX_SLOTS - 1)) {
+        if (col_id[id_index[i] - 1] == id) return id_index[i] - 1;
+    }
+    return -1;
+}
+
+static int lookup_username(const char *name) {
+    for (uint32_t i = hash_str(name) & (INDEX_SLOTS - 1); username_index[i]; i = (i + 1) & (INDEX_SLOTS - 1)) {
+        if (strcmp(col_username[username_index[i] - 1], name) == 0) return username_index[i] - 1;
+    }
+    return -1;
+}
+
+const char *web_sql_column_name(uint8_t column) {
+    return column < WEB_SQL_MAX_COLUMNS ? COLUMN_NAMES[column] : NULL;
+}
+
+web_sql_value_t web_sql_get(uint16_t row, uint8_t column) {
+    switch (column) {
+        case WEB_SQL_COL_ID:       return (web_sql_value_t){.is_int = true, .i = col_id[row]};
+        case WEB_SQL_COL_USERNAME: return (web_sql_value_t){.s = col_username[row]};
+        case WEB_SQL_COL_ROLE:     return (web_sql_value_t){.s = col_role[row]};
+        default:                   return (web_sql_value_t){.s = col_email[row]};
+    }
+}
+
+static bool fail(parser_t *p, const char *message) {
+    if (p->error == NULL) {
+        p->error = message;
+        p->error_pos = p->tok_start;
+    }
+    return false;
+}
+
+static bool is_ident_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Advance to the next token
+static bool next(parser_t *p) {
+    const char *s = p->src;
+    while (true) {
+        while (s[p->pos] == ' ' || s[p->pos] == '\t' || s[p->pos] == '\n' || s[p->pos] == '\r') p->pos++;
+        if (s[p->pos] == '-' && s[p->pos + 1] == '-') {
+            p->pos += strlen(s + p->pos);
+            continue;
+        }
+        break;
+    }
+
+    p->tok_start = p->pos;
+    char c = s[p->pos];
+    if (c == '\0') {
+        p->tok = TOK_END;
+    } else if ((c >= '0' && c <= '9') || (c == '-' && s[p->pos + 1] >= '0' && s[p->pos + 1] <= '9')) {
+        bool negative = c == '-';
+        if (negative) p->pos++;
+        int64_t v = 0;
+        while (s[p->pos] >= '0' && s[p->pos] <= '9') {
+            v = v * 10 + (s[p->pos++] - '0');
+            if (v > INT32_MAX) return fail(p, "integer out of range");
+        }
+        p->tok = TOK_INT;
+        p->tok_int = negative ? -v : v;
+    } else if (is_ident_char(c)) {
+        while (is_ident_char(s[p->pos])) p->pos++;
+        p->tok = TOK_IDENT;
+    } else if (c == '\'') {
+        // Unescape into the pool
+        char *out = p->pool + p->pool_len;
+        p->pos++;
+        while (true) {
+            if (s[p->pos] == '\0') return fail(p, "unterminated string");
+            if (s[p->pos] == '\'') {
+                if (s[p->pos + 1] != '\'') break;
+                p->pos++;
+            }
+            if (p->pool_len + 1 >= SQL_POOL_SIZE) return fail(p, "string literals too long");
+            p->pool[p->pool_len++] = s[p->pos++];
+        }
+        p->pos++;
+        p->pool[p->pool_len++] = '\0';
+        p->tok = TOK_STRING;
+        p->tok_str = out;
+    } else {
+        static const struct {
+            char text[3];
+            uint8_t tok;
+        } ops[] = {
+            {"<=", TOK_LE}, {">=", TOK_GE}, {"!=", TOK_NE}, {"<>", TOK_NE},
+            {"=", TOK_EQ}, {"<", TOK_LT}, {">", TOK_GT}, {"*", TOK_STAR},
+            {",", TOK_COMMA}, {"(", TOK_LPAREN}, {")", TOK_RPAREN}, {";", TOK_SEMI},
+        };
+        size_t i;
+        for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+            size_t n = strlen(ops[i].text);
+            if (strncmp(s + p->pos, ops[i].text, n) == 0) {
+                p->pos += n;
+                p->tok = ops[i].tok;
+                break;
+            }
+        }
+        if (i == sizeof(ops) / sizeof(ops[0])) return fail(p, "unexpected character");
+    }
+    p->tok_len = p->pos - p->tok_start;
+    return true;
+}
+
+// Current token is the given keyword
+static bool is_keyword(const parser_t *p, const char *word) {
+    return p->tok == TOK_IDENT && p->tok_len == strlen(word) &&
+           strncasecmp(p->src + p->tok_start, word, p->tok_len) == 0;
+}
+
+static bool expect_keyword(parser_t *p, const char *word, const char *message) {
+    return is_keyword(p, word) ? next(p) : fail(p, message);
+}
+
+// Column named by the current identifier, or -1
+static int column_of(const parser_t *p) {
+    for (int c = 0; c < WEB_SQL_MAX_COLUMNS; c++) {
+        if (p->tok_len == strlen(COLUMN_NAMES[c]) &&
+            strncasecmp(p->src + p->tok_start, COLUMN_NAMES[c], p->tok_len) == 0) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+static int new_node(parser_t *p, uint8_t type) {
+    if (p->num_nodes >= SQL_MAX_NODES) {
+        fail(p, "expression too complex");
+        return -1;
+    }
+    node_t *n = &p->nodes[p->num_nodes];
+    *n = (node_t){.type = type, .left = -1, .right = -1};
+    return p->num_nodes++;
+}
+
+static int parse_or(parser_t *p, int depth);
+
+static int parse_operand(parser_t *p) {
+    int n;
+    switch (p->tok) {
+        case TOK_INT:
+            if ((n = new_node(p, NODE_INT)) < 0) return -1;
+            p->nodes[n].value = p->tok_int;
+            break;
+        case TOK_STRING:
+            if ((n = new_node(p, NODE_STRING)) < 0) return -1;
+            p->nodes[n].str = p->tok_str;
+            break;
+        case TOK_IDENT: {
+            int column = column_of(p);
+            if (column < 0) {
+                fail(p, "no such column");
+                return -1;
+            }
+            if ((n = new_node(p, NODE_COLUMN)) < 0) return -1;
+            p->nodes[n].value = column;
+            break;
+        }
+        default:
+            fail(p, "expected a column, number or string");
+            return -1;
+    }
+    return next(p) ? n : -1;
+}
+
+static int parse_factor(parser_t *p, int depth) {
+    if (depth > SQL_MAX_DEPTH) {
+        fail(p, "expression nested too deeply");
+        return -1;
+    }
+
+    if (is_keyword(p, "NOT")) {
+        int n = new_node(p, NODE_NOT);
+        if (n < 0 || !next(p)) return -1;
+        int child = parse_factor(p, depth + 1);
+        if (child < 0) return -1;
+        p->nodes[n].left = child;
+        return n;
+    }
+
+    if (p->tok == TOK_LPAREN) {
+        if (!next(p)) return -1;
+        int n = parse_or(p, depth + 1);
+        if (n < 0) return -1;
+        if (p->tok != TOK_RPAREN) {
+            fail(p, "expected )");
+            return -1;
+        }
+        return next(p) ? n : -1;
+    }
+
+    int left = parse_operand(p);
+    if (left < 0) return -1;
+    if (p->tok < TOK_EQ || p->tok > TOK_GE) {
+        fail(p, "expected a comparison");
+        return -1;
+    }
+    int n = new_node(p, NODE_CMP);
+    if (n < 0) return -1;
+    p->nodes[n].op = p->tok;
+    if (!next(p)) return -1;
+    int right = parse_operand(p);
+    if (right < 0) return -1;
+    p->nodes[n].left = left;
+    p->nodes[n].right = right;
+    return n;
+}
+
+static int parse_and(parser_t *p, int depth) {
+    int left = parse_factor(p, depth);
+    while (left >= 0 && is_keyword(p, "AND")) {
+        int n = new_node(p, NODE_AND);
+        if (n < 0 || !next(p)) return -1;
+        int right = parse_factor(p, depth);
+        if (right < 0) return -1;
+        p->nodes[n].left = left;
+        p->nodes[n].right = right;
+        left = n;
+    }
+    return left;
+}
+
+static int parse_or(parser_t *p, int depth) {
+    int left = parse_and(p, depth);
+    while (left >= 0 && is_keyword(p, "OR")) {
+        int n = new_node(p, NODE_OR);
+        if (n < 0 || !next(p)) return -1;
+        int right = parse_and(p, depth);
+        if (right < 0) return -1;
+        p->nodes[n].left = left;
+        p->nodes[n].right = right;
+        left = n;
+    }
+    return left;
+}
+
+static web_sql_value_t operand_value(const node_t *n, uint16_t row) {
+    switch (n->type) {
+        case NODE_COLUMN: return web_sql_get(row, n->value);
+        case NODE_INT:    return (web_sql_value_t){.is_int = true, .i = n->value};
+        default:          return (web_sql_value_t){.s = n->str};
+    }
+}
+
+// Integers compare numerically; anything involving a string compares the
+// text, so id = '1' matches like it would in SQLite
+static int compare(web_sql_value_t a, web_sql_value_t b) {
+    if (a.is_int && b.is_int) return (a.i > b.i) - (a.i < b.i);
+    char abuf[12], bbuf[12];
+    if (a.is_int) {
+        snprintf(abuf, sizeof(abuf), "%ld", (long)a.i);
+        a.s = abuf;
+    }
+    if (b.is_int) {
+        snprintf(bbuf, sizeof(bbuf), "%ld", (long)b.i);
+        b.s = bbuf;
+    }
+    return strcmp(a.s, b.s);
+}
+
+static bool eval(const parser_t *p, int idx, uint16_t row) {
+    const node_t *n = &p->nodes[idx];
+    switch (n->type) {
+        case NODE_AND: return eval(p, n->left, row) && eval(p, n->right, row);
+        case NODE_OR:  return eval(p, n->left, row) || eval(p, n->right, row);
+        case NODE_NOT: return !eval(p, n->left, row);
+        case NODE_CMP: {
+            int c = compare(operand_value(&p->nodes[n->left], row), operand_value(&p->nodes[n->right], row));
+            switch (n->op) {
+                case TOK_EQ: return c == 0;
+                case TOK_NE: return c != 0;
+                case TOK_LT: return c < 0;
+                case TOK_LE: return c <= 0;
+                case TOK_GT: return c > 0;
+                default:     return c >= 0;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
+// Find an indexed equality in the top-level AND chain. Returns false if
+// there is none; otherwise *row is the only candidate (-1: no match).
+static bool plan_index(const parser_t *p, int idx, int *row) {
+    const node_t *n = &p->nodes[idx];
+    if (n->type == NODE_AND) {
+        return plan_index(p, n->left, row) || plan_index(p, n->right, row);
+    }
+    if (n->type != NODE_CMP || n->op != TOK_EQ) return false;
+
+    const node_t *a = &p->nodes[n->left], *b = &p->nodes[n->right];
+    if (a->type != NODE_COLUMN) {
+        const node_t *t = a;
+        a = b;
+        b = t;
+    }
+    if (a->type != NODE_COLUMN) return false;
+    if (a->value == WEB_SQL_COL_ID && b->type == NODE_INT) {
+        *row = lookup_id(b->value);
+        return true;
+    }
+    if (a->value == WEB_SQL_COL_USERNAME && b->type == NODE_STRING) {
+        *row = lookup_username(b->str);
+        return true;
+    }
+    return false;
+}
+
+static bool parse_select(parser_t *p, web_sql_result_t *result, int *where, uint32_t *limit) {
+    if (!next(p) || !expect_keyword(p, "SELECT", "expected SELECT")) return false;
+
+    if (p->tok == TOK_STAR) {
+        for (int c = 0; c < WEB_SQL_MAX_COLUMNS; c++) {
+            result->columns[c] = c;
+        }
+        result->num_columns = WEB_SQL_MAX_COLUMNS;
+        if (!next(p)) return false;
+    } else {
+        while (true) {
+            int column = p->tok == TOK_IDENT ? column_of(p) : -1;
+            if (column < 0) return fail(p, "no such column");
+            if (result->num_columns >= WEB_SQL_MAX_COLUMNS) return fail(p, "too many columns");
+            result->columns[result->num_columns++] = column;
+            if (!next(p)) return false;
+            if (p->tok != TOK_COMMA) break;
+            if (!next(p)) return false;
+        }
+    }
+
+    if (!expect_keyword(p, "FROM", "expected FROM")) return false;
+    if (!expect_keyword(p, "users", "no such table")) return false;
+
+    *where = -1;
+    if (is_keyword(p, "WHERE")) {
+        if (!next(p)) return false;
+        *where = parse_or(p, 0);
+        if (*where < 0) return false;
+    }
+
+    *limit = WEB_SQL_TABLE_ROWS;
+    if (is_keyword(p, "LIMIT")) {
+        if (!next(p)) return false;
+        if (p->tok != TOK_INT || p->tok_int < 0) return fail(p, "expected a row count");
+        *limit = p->tok_int;
+        if (!next(p)) return false;
+    }
+
+    bool terminated = p->tok == TOK_SEMI;
+    if (terminated && !next(p)) return false;
+    if (p->tok != TOK_END) {
+        return fail(p, terminated ? "only one statement allowed" : "unexpected input after query");
+    }
+    return true;
+}
+
+esp_err_t web_sql_exec(const char *query, web_sql_result_t *result) {
+    parser_t p = {.src = query};
+    memset(result, 0, sizeof(*result));
+
+    int where;
+    uint32_t limit;
+    if (!parse_select(&p, result, &where, &limit)) {
+        result->error = p.error;
+        result->error_pos = p.error_pos;
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int candidate;
+    if (where >= 0 && plan_index(&p, where, &candidate)) {
+        result->used_index = true;
+        if (candidate >= 0 && limit > 0 && eval(&p, where, candidate)) {
+            result->rows[result->num_rows++] = candidate;
+        }
+        return ESP_OK;
+    }
+
+    for (uint16_t row = 0; row < WEB_SQL_TABLE_ROWS && result->num_rows < limit; row++) {
+        if (where < 0 || eval(&p, where, row)) {
+            result->rows[result->num_rows++] = row;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,63 @@
+// components/web_module/web_status.c
+#include "web_status.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+
+typedef struct {
+    atomic_uint seq;            // Odd while a write is in progress
+    challenge_status_t status;
+} status_slot_t;
+
+static status_slot_t slots[WEB_STATUS_MAX_CHALLENGES];
+static portMUX_TYPE writer_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline unsigned write_begin(status_slot_t *slot) {
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    return seq;
+}
+
+static inline void write_end(status_slot_t *slot, unsigned seq) {
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+void web_status_reset(uint8_t id, uint32_t start_time) {
+    if (id >= WEB_STATUS_MAX_CHALLENGES) return;
+    status_slot_t *slot = &slots[id];
+
+    taskENTER_CRITICAL(&writer_lock);
+    unsigned seq = write_begin(slot);
+    slot->status = (challenge_status_t){.start_time = start_time};
+    write_end(slot, seq);
+    taskEXIT_CRITICAL(&writer_lock);
+}
+
+void web_status_record(uint8_t id, bool success, uint32_t bytes, uint32_t latency_us) {
+    if (id >= WEB_STATUS_MAX_CHALLENGES) return;
+    status_slot_t *slot = &slots[id];
+
+    taskENTER_CRITICAL(&writer_lock);
+    unsigned seq = write_begin(slot);
+    slot->status.attempts++;
+    slot->status.successes += success;
+    slot->status.completed |= success;
+    slot->status.bytes += bytes;
+    slot->status.last_latency_us = latency_us;
+    write_end(slot, seq);
+    taskEXIT_CRITICAL(&writer_lock);
+}
+
+bool web_status_read(uint8_t id, challenge_status_t *out) {
+    if (id >= WEB_STATUS_MAX_CHALLENGES) return false;
+    const status_slot_t *slot = &slots[id];
+
+    unsigned before, after;
+    do {
+        before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        *out = slot->status;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return true;
+}
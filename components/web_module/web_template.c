@@ -0,0 +1,77 @@
+// components/web_module/web_template.c
+#include "web_template.h"
+#include <string.h>
+
+#define ESCAPE_BUF_LEN  64
+
+static const char *html_entity(char c) {
+    switch (c) {
+        case '&':  return "&amp;";
+        case '<':  return "&lt;";
+        case '>':  return "&gt;";
+        case '"':  return "&quot;";
+        case '\'': return "&#39;";
+        default:   return NULL;
+    }
+}
+
+// Send runs of safe characters straight from the value and batch the
+// entities through a small buffer
+static esp_err_t send_escaped(httpd_req_t *req, const char *value) {
+    char buf[ESCAPE_BUF_LEN];
+    size_t used = 0;
+    const char *run = value;
+    esp_err_t err = ESP_OK;
+
+    for (const char *p = value; ; p++) {
+        const char *entity = *p ? html_entity(*p) : NULL;
+        if (entity == NULL && *p) continue;
+
+        if (p > run) {
+            if (used > 0) {
+                err = httpd_resp_send_chunk(req, buf, used);
+                used = 0;
+            }
+            if (err == ESP_OK) err = httpd_resp_send_chunk(req, run, p - run);
+            if (err != ESP_OK) return err;
+        }
+        if (*p == '\0') break;
+
+        size_t n = strlen(entity);
+        if (used + n > sizeof(buf)) {
+            err = httpd_resp_send_chunk(req, buf, used);
+            if (err != ESP_OK) return err;
+            used = 0;
+        }
+        memcpy(buf + used, entity, n);
+        used += n;
+        run = p + 1;
+    }
+
+    return used > 0 ? httpd_resp_send_chunk(req, buf, used) : ESP_OK;
+}
+
+esp_err_t web_template_render(httpd_req_t *req, const web_template_t *tpl, const char *const *values) {
+    httpd_resp_set_type(req, "text/html");
+
+    for (uint16_t i = 0; i < tpl->num_parts; i++) {
+        const tpl_part_t *part = &tpl->parts[i];
+        const char *value = part->type == TPL_PART_LITERAL ? NULL : values[part->slot];
+        esp_err_t err = ESP_OK;
+
+        switch (part->type) {
+            case TPL_PART_LITERAL:
+                err = httpd_resp_send_chunk(req, part->text, part->len);
+                break;
+            case TPL_PART_ESCAPED:
+                if (value && *value) err = send_escaped(req, value);
+                break;
+            case TPL_PART_RAW:
+                if (value && *value) err = httpd_resp_send_chunk(req, value, strlen(value));
+                break;
+        }
+        if (err != ESP_OK) return err;
+    }
+
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
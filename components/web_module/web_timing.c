@@ -0,0 +1,67 @@
+// components/web_module/web_timing.c
+#include "web_timing.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_cpu.h"
+#endif
+
+// Same secret as the local lesson in hardware_module
+static const char SECRET[] = "SecretPassword123";
+
+static portMUX_TYPE timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t cycle_count(void) {
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000u + ts.tv_nsec;
+#else
+    return esp_cpu_get_cycle_count();
+#endif
+}
+
+// What a naive strcmp-style check does: the time taken gives away how
+// many leading characters were right
+static __attribute__((noinline)) bool compare_leaky(const char *guess) {
+    for (size_t i = 0; i < sizeof(SECRET); i++) {
+        if (guess[i] != SECRET[i]) return false;
+    }
+    return true;
+}
+
+// Same work whatever the guess; only the guess length bounds what is read
+static __attribute__((noinline)) bool compare_constant(const char *guess) {
+    size_t len = strnlen(guess, WEB_TIMING_MAX_GUESS);
+    uint8_t diff = len != sizeof(SECRET) - 1;
+    for (size_t i = 0; i < sizeof(SECRET) - 1; i++) {
+        // Past the end of the guess compare against its terminator
+        diff |= (uint8_t)(guess[i < len ? i : len] ^ SECRET[i]);
+    }
+    return diff == 0;
+}
+
+uint32_t web_timing_compare(const char *guess, web_timing_mode_t mode, bool *match) {
+    bool (*compare)(const char *) = mode == WEB_TIMING_CONSTANT ? compare_constant : compare_leaky;
+
+    // Warm the caches, then time one run with interrupts and preemption
+    // out of the way
+    compare(guess);
+    taskENTER_CRITICAL(&timing_lock);
+    uint32_t start = cycle_count();
+    *match = compare(guess);
+    uint32_t cycles = cycle_count() - start;
+    taskEXIT_CRITICAL(&timing_lock);
+    return cycles;
+}
+
+uint32_t web_timing_cycles_per_us(void) {
+#if CONFIG_IDF_TARGET_LINUX
+    return 1000;
+#else
+    return CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+#endif
+}
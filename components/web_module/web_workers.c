@@ -0,0 +1,196 @@
+// components/web_module/web_workers.c
+#include "web_workers.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+
+static const char *TAG = "web_workers";
+
+#define WEB_WORKER_PRIORITY     5
+
+// Every worker reads bodies into its own arena (see web_body.c)
+_Static_assert(CONFIG_WEB_BODY_ARENAS >= CONFIG_WEB_WORKER_COUNT,
+               "CONFIG_WEB_BODY_ARENAS must cover every worker task");
+
+typedef struct {
+    esp_err_t (*handler)(httpd_req_t *req);
+    web_ratelimit_t rate_limit;
+    uint8_t id;
+    web_endpoint_stats_t stats;
+} web_endpoint_t;
+
+typedef struct {
+    httpd_req_t *req;           // Async copy owned by the worker
+    web_endpoint_t *endpoint;
+    int64_t queued_us;
+} web_job_t;
+
+static QueueHandle_t job_queue = NULL;
+static web_endpoint_t endpoints[WEB_WORKERS_MAX_ENDPOINTS];
+static size_t num_endpoints = 0;
+static uint32_t queue_high_water = 0;
+static uint32_t stack_free_min = UINT32_MAX;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_err_t send_busy(httpd_req_t *req) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    return httpd_resp_sendstr(req, "{\"status\":\"error\",\"message\":\"Server busy, retry shortly\"}");
+}
+
+static esp_err_t send_throttled(httpd_req_t *req, uint32_t retry_after_s) {
+    char retry_after[12];
+    snprintf(retry_after, sizeof(retry_after), "%lu", (unsigned long)retry_after_s);
+    httpd_resp_set_status(req, "429 Too Many Requests");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Retry-After", retry_after);
+    return httpd_resp_sendstr(req, "{\"status\":\"error\",\"message\":\"Too many requests, slow down\"}");
+}
+
+static void reject(web_endpoint_t *ep) {
+    taskENTER_CRITICAL(&stats_lock);
+    ep->stats.rejected++;
+    taskEXIT_CRITICAL(&stats_lock);
+}
+
+// Runs on the httpd task: hand the request to the pool and return at once
+static esp_err_t dispatch_handler(httpd_req_t *req) {
+    web_endpoint_t *ep = req->user_ctx;
+
+    // Per-client limit first, so one client's flood never takes the
+    // endpoint's worker slots
+    uint32_t retry_after_s;
+    if (!web_ratelimit_allow(req, ep->id, &ep->rate_limit, &retry_after_s)) {
+        taskENTER_CRITICAL(&stats_lock);
+        ep->stats.throttled++;
+        taskEXIT_CRITICAL(&stats_lock);
+        return send_throttled(req, retry_after_s);
+    }
+
+    bool admitted = false;
+    taskENTER_CRITICAL(&stats_lock);
+    if (ep->stats.in_flight < ep->stats.max_in_flight) {
+        ep->stats.in_flight++;
+        admitted = true;
+    }
+    taskEXIT_CRITICAL(&stats_lock);
+    if (!admitted) {
+        reject(ep);
+        return send_busy(req);
+    }
+
+    web_job_t job = {.endpoint = ep, .queued_us = esp_timer_get_time()};
+    if (httpd_req_async_handler_begin(req, &job.req) != ESP_OK) {
+        taskENTER_CRITICAL(&stats_lock);
+        ep->stats.in_flight--;
+        taskEXIT_CRITICAL(&stats_lock);
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+    }
+
+    if (xQueueSend(job_queue, &job, 0) != pdTRUE) {
+        httpd_req_async_handler_complete(job.req);
+        taskENTER_CRITICAL(&stats_lock);
+        ep->stats.in_flight--;
+        taskEXIT_CRITICAL(&stats_lock);
+        reject(ep);
+        return send_busy(req);
+    }
+
+    uint32_t depth = uxQueueMessagesWaiting(job_queue);
+    if (depth > queue_high_water) queue_high_water = depth;
+    return ESP_OK;
+}
+
+static void worker_task(void *pvParameters) {
+    web_job_t job;
+    while (1) {
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+        uint32_t waited = esp_timer_get_time() - job.queued_us;
+        web_endpoint_t *ep = job.endpoint;
+        if (ep->handler(job.req) != ESP_OK) {
+            // Same as returning ESP_FAIL from a synchronous handler
+            httpd_sess_trigger_close(job.req->handle, httpd_req_to_sockfd(job.req));
+        }
+        httpd_req_async_handler_complete(job.req);
+
+        taskENTER_CRITICAL(&stats_lock);
+        ep->stats.in_flight--;
+        ep->stats.served++;
+        ep->stats.queue_time_total_us += waited;
+        if (waited > ep->stats.queue_time_max_us) ep->stats.queue_time_max_us = waited;
+        taskEXIT_CRITICAL(&stats_lock);
+
+        uint32_t stack_free = uxTaskGetStackHighWaterMark(NULL);
+        if (stack_free < stack_free_min) stack_free_min = stack_free;
+    }
+}
+
+esp_err_t web_workers_start(void) {
+    if (job_queue != NULL) return ESP_OK;
+
+    job_queue = xQueueCreate(CONFIG_WEB_WORKER_QUEUE_LEN, sizeof(web_job_t));
+    if (job_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create job queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < CONFIG_WEB_WORKER_COUNT; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "web_worker_%d", i);
+        if (xTaskCreate(worker_task, name, CONFIG_WEB_WORKER_STACK_SIZE, NULL,
+                        WEB_WORKER_PRIORITY, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create %s", name);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    ESP_LOGI(TAG, "%d workers, queue depth %d", CONFIG_WEB_WORKER_COUNT, CONFIG_WEB_WORKER_QUEUE_LEN);
+    return ESP_OK;
+}
+
+esp_err_t web_workers_register(httpd_handle_t server, const httpd_uri_t *uri, uint8_t max_in_flight,
+                               const web_ratelimit_t *rate_limit) {
+    if (num_endpoints == WEB_WORKERS_MAX_ENDPOINTS || max_in_flight == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    web_endpoint_t *ep = &endpoints[num_endpoints];
+    ep->handler = uri->handler;
+    ep->rate_limit = *rate_limit;
+    ep->id = num_endpoints;
+    ep->stats.uri = uri->uri;
+    ep->stats.max_in_flight = max_in_flight;
+
+    httpd_uri_t wrapped = *uri;
+    wrapped.handler = dispatch_handler;
+    wrapped.user_ctx = ep;
+    esp_err_t ret = httpd_register_uri_handler(server, &wrapped);
+    if (ret == ESP_OK) {
+        num_endpoints++;
+    }
+    return ret;
+}
+
+size_t web_workers_get_stats(web_endpoint_stats_t *out, size_t max_out) {
+    size_t n = num_endpoints < max_out ? num_endpoints : max_out;
+    taskENTER_CRITICAL(&stats_lock);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = endpoints[i].stats;
+    }
+    taskEXIT_CRITICAL(&stats_lock);
+    return n;
+}
+
+uint32_t web_workers_queue_high_water(void) {
+    return queue_high_water;
+}
+
+uint32_t web_workers_stack_free_min(void) {
+    return stack_free_min == UINT32_MAX ? 0 : stack_free_min;
+}
@@ -0,0 +1,85 @@
+// components/web_module/web_ws_clients.c
+#include "web_ws_clients.h"
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "web_ws_clients";
+
+void web_ws_clients_init(web_ws_clients_t *c, httpd_handle_t server, uint8_t size) {
+    c->server = server;
+    c->size = size < WEB_WS_CLIENTS_MAX ? size : WEB_WS_CLIENTS_MAX;
+    for (int i = 0; i < WEB_WS_CLIENTS_MAX; i++) {
+        c->slots[i] = (web_ws_slot_t){.fd = -1};
+    }
+}
+
+esp_err_t web_ws_clients_add(web_ws_clients_t *c, int fd) {
+    // A reused fd must take over its stale slot, not sit next to it
+    int slot = -1;
+    taskENTER_CRITICAL(&c->lock);
+    for (int i = 0; i < c->size; i++) {
+        if (c->slots[i].fd == fd) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && c->slots[i].fd < 0) slot = i;
+    }
+    if (slot >= 0) {
+        c->slots[slot].fd = fd;
+        c->slots[slot].gen++;
+    }
+    taskEXIT_CRITICAL(&c->lock);
+    if (slot < 0) return ESP_ERR_NO_MEM;
+
+    // One sender task serves every client in turn, so a send that blocks
+    // for the server's usual timeout would stall all of them; a client
+    // that cannot keep up fails fast and is dropped instead
+    struct timeval timeout = {
+        .tv_sec = CONFIG_WEB_WS_SEND_TIMEOUT_MS / 1000,
+        .tv_usec = CONFIG_WEB_WS_SEND_TIMEOUT_MS % 1000 * 1000,
+    };
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0) {
+        ESP_LOGW(TAG, "Could not set the send timeout of client %d", fd);
+    }
+    return ESP_OK;
+}
+
+bool web_ws_clients_get(web_ws_clients_t *c, int i, web_ws_slot_t *slot) {
+    taskENTER_CRITICAL(&c->lock);
+    *slot = c->slots[i];
+    taskEXIT_CRITICAL(&c->lock);
+    return slot->fd >= 0;
+}
+
+void web_ws_clients_remove(web_ws_clients_t *c, int i, const web_ws_slot_t *slot) {
+    taskENTER_CRITICAL(&c->lock);
+    if (c->slots[i].gen == slot->gen) c->slots[i].fd = -1;
+    taskEXIT_CRITICAL(&c->lock);
+}
+
+bool web_ws_clients_alive(web_ws_clients_t *c, int i, const web_ws_slot_t *slot) {
+    if (httpd_ws_get_fd_info(c->server, slot->fd) == HTTPD_WS_CLIENT_WEBSOCKET) return true;
+    web_ws_clients_remove(c, i, slot);
+    return false;
+}
+
+esp_err_t web_ws_clients_send(web_ws_clients_t *c, int i, const web_ws_slot_t *slot,
+                              httpd_ws_frame_t *frame) {
+    if (!web_ws_clients_alive(c, i, slot)) return ESP_ERR_INVALID_STATE;
+    esp_err_t ret = httpd_ws_send_frame_async(c->server, slot->fd, frame);
+    if (ret != ESP_OK) {
+        web_ws_clients_remove(c, i, slot);
+        httpd_sess_trigger_close(c->server, slot->fd);
+    }
+    return ret;
+}
+
+esp_err_t web_ws_discard(httpd_req_t *req) {
+    uint8_t buf[64];
+    httpd_ws_frame_t frame = {.payload = buf};
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK || frame.len > sizeof(buf)) return ESP_FAIL;
+    return frame.len ? httpd_ws_recv_frame(req, &frame, sizeof(buf)) : ESP_OK;
+}
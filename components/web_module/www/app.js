@@ -0,0 +1,112 @@
+// Posts each challenge form as JSON and shows the response below it
+document.querySelectorAll('form[data-endpoint]').forEach(function (form) {
+  var result = form.nextElementSibling;
+  form.addEventListener('submit', function (event) {
+    event.preventDefault();
+    var body = {};
+    new FormData(form).forEach(function (value, key) { body[key] = value; });
+
+    fetch(form.dataset.endpoint, {
+      method: 'POST',
+      headers: {'Content-Type': 'application/json'},
+      body: JSON.stringify(body)
+    }).then(function (resp) {
+      return resp.text().then(function (text) {
+        if (form.hasAttribute('data-html')) {
+          // Rendered in a sandboxed frame so injected scripts run in an opaque origin
+          result.srcdoc = text;
+        } else {
+          var timing = resp.headers.get('Server-Timing');
+          result.textContent = resp.status + ' ' + text + (timing ? '\nServer-Timing: ' + timing : '');
+        }
+      });
+    }).catch(function (err) {
+      result.textContent = 'Request failed: ' + err;
+    });
+  });
+});
+
+// Live event feed from /events; reconnects after a few seconds if dropped
+(function () {
+  var list = document.getElementById('events');
+  var state = document.getElementById('events-state');
+  var MAX_ROWS = 100;
+
+  function add(text) {
+    var row = document.createElement('li');
+    row.textContent = text;
+    list.insertBefore(row, list.firstChild);
+    while (list.childNodes.length > MAX_ROWS) list.removeChild(list.lastChild);
+  }
+
+  function connect() {
+    var ws = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/events');
+    ws.onopen = function () { state.textContent = 'Connected'; };
+    ws.onclose = function () {
+      state.textContent = 'Disconnected, retrying...';
+      setTimeout(connect, 3000);
+    };
+    ws.onmessage = function (msg) {
+      var frame = JSON.parse(msg.data);
+      if (frame.dropped) add('... ' + frame.dropped + ' events skipped');
+      frame.events.forEach(function (ev) {
+        add((ev.t / 1000).toFixed(1) + 's ' + ev.src + '/' + ev.type + ' ' + JSON.stringify(ev.data));
+      });
+    };
+  }
+  connect();
+})();
+
+// Device screen from /fb: binary frames of XOR deltas, run-length coded per
+// 128-byte page (format in web_fb.h)
+(function () {
+  var canvas = document.getElementById('screen');
+  var state = document.getElementById('screen-state');
+  var ctx = canvas.getContext('2d');
+  var image = ctx.createImageData(128, 64);
+  var fb = new Uint8Array(1024);
+
+  function apply(data) {
+    var pos = 2;
+    if (data[0] & 1) fb.fill(0);
+    for (var page = 0; page < 8; page++) {
+      if (!(data[1] & (1 << page))) continue;
+      var x = 0;
+      while (x < 128) {
+        var token = data[pos++];
+        var n = (token & 0x7f) + 1;
+        for (var i = 0; i < n; i++) {
+          fb[page * 128 + x++] ^= data[(token & 0x80) ? pos : pos + i];
+        }
+        pos += (token & 0x80) ? 1 : n;
+      }
+    }
+  }
+
+  function draw() {
+    for (var y = 0; y < 64; y++) {
+      for (var x = 0; x < 128; x++) {
+        var on = fb[(y >> 3) * 128 + x] & (1 << (y & 7));
+        var p = (y * 128 + x) * 4;
+        image.data[p] = image.data[p + 1] = image.data[p + 2] = on ? 255 : 0;
+        image.data[p + 3] = 255;
+      }
+    }
+    ctx.putImageData(image, 0, 0);
+  }
+
+  function connect() {
+    var ws = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/fb');
+    ws.binaryType = 'arraybuffer';
+    ws.onopen = function () { state.textContent = 'Connected'; };
+    ws.onclose = function () {
+      state.textContent = 'Disconnected, retrying...';
+      setTimeout(connect, 3000);
+    };
+    ws.onmessage = function (msg) {
+      apply(new Uint8Array(msg.data));
+      draw();
+    };
+  }
+  connect();
+})();
@@ -8,6 +8,7 @@
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "network_challenges.h"
+#include "display.h"
 #include "driver/gpio.h"
 
 static const char *TAG = "network_main";
@@ -16,6 +17,11 @@ static const char *TAG = "network_main";
 #define BUTTON_NEXT_CHALLENGE GPIO_NUM_39
 #define BUTTON_START_STOP     GPIO_NUM_34
 
+// Display used for the channel survey chart
+#define DISPLAY_SDA GPIO_NUM_21
+#define DISPLAY_SCL GPIO_NUM_22
+#define DISPLAY_ADDRESS 0x3C
+
 // Current challenge tracking
 static network_challenge_type_t current_challenge = NET_CHALLENGE_BEACON_ANALYSIS;
 static bool challenge_running = false;
@@ -27,7 +33,7 @@ static void IRAM_ATTR button_isr_handler(void* arg) {
     if (gpio_num == BUTTON_NEXT_CHALLENGE) {
         // Cycle through challenges
         if (!challenge_running) {
-            current_challenge = (current_challenge + 1) % 5;
+            current_challenge = (current_challenge + 1) % NET_CHALLENGE_COUNT;
         }
     } else if (gpio_num == BUTTON_START_STOP) {
         challenge_running = !challenge_running;
@@ -119,6 +125,16 @@ void print_challenge_instructions(network_challenge_type_t challenge) {
             printf("- Compare network characteristics\n");
             printf("- Learn prevention techniques\n");
             break;
+
+        case NET_CHALLENGE_CHANNEL_SURVEY:
+            printf("Channel Survey Challenge:\n");
+            printf("- Measure how busy each WiFi channel is\n");
+            printf("- Compare management, control and data airtime\n");
+            printf("- Pick the least congested channel for a new network\n");
+            break;
+
+        default:
+            break;
     }
     printf("\nControls:\n");
     printf("- Press NEXT button to cycle through challenges\n");
@@ -142,6 +158,19 @@ void app_main(void)
     // Initialize the buttons for user interaction
     init_buttons();
 
+    // The display is optional; the survey falls back to the log without it
+    display_config_t display_config = {
+        .width = 128,
+        .height = 64,
+        .i2c_port = I2C_NUM_0,
+        .i2c_addr = DISPLAY_ADDRESS,
+        .sda_pin = DISPLAY_SDA,
+        .scl_pin = DISPLAY_SCL
+    };
+    if (display_init(&display_config) != ESP_OK) {
+        ESP_LOGW(TAG, "Display not available");
+    }
+
     // Initialize the network challenges module
     ESP_ERROR_CHECK(network_challenges_init());
 
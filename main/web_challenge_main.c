@@ -5,15 +5,27 @@
 #include "esp_system.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
+#include "esp_netif.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "web_challenges.h"
+#include "web_captive.h"
+#include "web_fb.h"
+#include "display.h"
 
 #define WIFI_SSID "ESP_Security_Lab"
 #define WIFI_PASS "training123"
 
+#define DISPLAY_SDA GPIO_NUM_21
+#define DISPLAY_SCL GPIO_NUM_22
+#define DISPLAY_ADDRESS 0x3C
+
+#define CHALLENGE_COUNT 4       // auth, sqli, xss, timing
+
 static const char *TAG = "web_challenge_main";
 
+static esp_netif_t *ap_netif;
+
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                              int32_t event_id, void* event_data)
 {
@@ -32,7 +44,7 @@ void wifi_init_softap(void)
 {
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_ap();
+    ap_netif = esp_netif_create_default_wifi_ap();
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
@@ -48,7 +60,7 @@ void wifi_init_softap(void)
             .ssid = WIFI_SSID,
             .ssid_len = strlen(WIFI_SSID),
             .password = WIFI_PASS,
-            .max_connection = 4,
+            .max_connection = 10,
             .authmode = WIFI_AUTH_WPA_WPA2_PSK
         },
     };
@@ -60,6 +72,27 @@ void wifi_init_softap(void)
     ESP_LOGI(TAG, "WiFi AP started with SSID:%s password:%s", WIFI_SSID, WIFI_PASS);
 }
 
+// Hand out the AP as DNS server and answer every name with its address, so
+// joining clients are taken to the challenge UI by their OS
+static void captive_portal_start(void)
+{
+    esp_netif_ip_info_t ip_info;
+    ESP_ERROR_CHECK(esp_netif_get_ip_info(ap_netif, &ip_info));
+
+    esp_netif_dns_info_t dns = {
+        .ip.u_addr.ip4.addr = ip_info.ip.addr,
+        .ip.type = ESP_IPADDR_TYPE_V4,
+    };
+    uint8_t offer_dns = DHCPS_OFFER_DNS;
+    ESP_ERROR_CHECK(esp_netif_dhcps_stop(ap_netif));
+    ESP_ERROR_CHECK(esp_netif_dhcps_option(ap_netif, ESP_NETIF_OP_SET, ESP_NETIF_DOMAIN_NAME_SERVER,
+                                           &offer_dns, sizeof(offer_dns)));
+    ESP_ERROR_CHECK(esp_netif_set_dns_info(ap_netif, ESP_NETIF_DNS_MAIN, &dns));
+    ESP_ERROR_CHECK(esp_netif_dhcps_start(ap_netif));
+
+    ESP_ERROR_CHECK(web_captive_dns_start(ip_info.ip.addr));
+}
+
 void app_main(void)
 {
     // Initialize NVS
@@ -75,6 +108,7 @@ void app_main(void)
 
     // Initialize web challenges
     ESP_ERROR_CHECK(web_challenges_init());
+    captive_portal_start();
 
     // Start the first challenge
     ESP_ERROR_CHECK(start_challenge(0));
@@ -90,4 +124,40 @@ void app_main(void)
     ESP_LOGI(TAG, "1. Authentication: POST http://192.168.4.1/auth");
     ESP_LOGI(TAG, "2. SQL Injection: POST http://192.168.4.1/query");
     ESP_LOGI(TAG, "3. XSS: POST http://192.168.4.1/message");
-}
\ No newline at end of file
+    ESP_LOGI(TAG, "4. Timing: POST http://192.168.4.1/timing");
+    ESP_LOGI(TAG, "Session: GET http://192.168.4.1/whoami");
+    ESP_LOGI(TAG, "Progress: GET http://192.168.4.1/status");
+    ESP_LOGI(TAG, "Screen mirror: ws://192.168.4.1/fb");
+
+    // The display is optional; with one, it charts attempts per challenge
+    // and every refresh is mirrored to /fb
+    display_config_t display_config = {
+        .width = 128,
+        .height = 64,
+        .i2c_port = I2C_NUM_0,
+        .i2c_addr = DISPLAY_ADDRESS,
+        .sda_pin = DISPLAY_SDA,
+        .scl_pin = DISPLAY_SCL
+    };
+    if (display_init(&display_config) != ESP_OK) {
+        ESP_LOGW(TAG, "Display not available");
+        return;
+    }
+    ESP_ERROR_CHECK(display_set_refresh_cb(web_fb_update, NULL));
+
+    while (1) {
+        uint32_t attempts[CHALLENGE_COUNT];
+        uint32_t most = 1;
+        for (uint8_t i = 0; i < CHALLENGE_COUNT; i++) {
+            attempts[i] = get_challenge_status(i).attempts;
+            if (attempts[i] > most) most = attempts[i];
+        }
+        uint8_t bars[CHALLENGE_COUNT];
+        for (uint8_t i = 0; i < CHALLENGE_COUNT; i++) {
+            bars[i] = (uint64_t)attempts[i] * 100 / most;
+        }
+        // Unchanged charts cost neither I2C writes nor mirror frames
+        display_show_bar_chart("Attempts", bars, CHALLENGE_COUNT);
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
@@ -0,0 +1,181 @@
+// tools/ble_adv_bench/main/ble_adv_bench.c
+//
+// Runs the BLE advertising-data parser and decoders over a corpus of
+// captured reports on the host and reports throughput.
+//
+//   idf.py --preview set-target linux && idf.py build
+//   ./build/ble_adv_bench.elf
+//
+// Environment:
+//   BENCH_CORPUS    report corpus (default corpus/reports.txt)
+//   BENCH_LOOPS     number of passes over the corpus (default 100000)
+//   BENCH_MIN_RATE  fail (exit 1) if reports/s falls below this
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ble_adv.h"
+
+#define MAX_REPORTS     1024
+#define MAX_DATA_LEN    31
+
+typedef struct {
+    uint8_t adv[MAX_DATA_LEN];
+    uint8_t rsp[MAX_DATA_LEN];
+    uint8_t adv_len;
+    uint8_t rsp_len;
+} bench_report_t;
+
+typedef struct {
+    unsigned long malformed;
+    unsigned long named;
+    unsigned long ibeacon;
+    unsigned long eddystone;
+    unsigned long continuity;
+} bench_counts_t;
+
+static bench_report_t reports[MAX_REPORTS];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long env_ulong(const char *name, unsigned long fallback) {
+    const char *value = getenv(name);
+    return value ? strtoul(value, NULL, 10) : fallback;
+}
+
+// Hex field into out; "-" is an empty field. Returns -1 on bad input.
+static int parse_hex(const char *s, size_t n, uint8_t *out) {
+    if (n == 1 && s[0] == '-') return 0;
+    if (n % 2 != 0 || n / 2 > MAX_DATA_LEN) return -1;
+    for (size_t i = 0; i < n; i += 2) {
+        char byte[3] = {s[i], s[i + 1], '\0'};
+        char *end;
+        out[i / 2] = strtoul(byte, &end, 16);
+        if (*end != '\0') return -1;
+    }
+    return n / 2;
+}
+
+static size_t load_corpus(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+
+    char line[256];
+    size_t count = 0;
+    unsigned lineno = 0;
+    while (count < MAX_REPORTS && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        bench_report_t *r = &reports[count];
+        size_t n = strcspn(p, " \t\r\n");
+        int adv = parse_hex(p, n, r->adv);
+        p += n;
+        while (*p == ' ' || *p == '\t') p++;
+        int rsp = parse_hex(p, strcspn(p, " \t\r\n"), r->rsp);
+        if (adv < 0 || rsp < 0) {
+            printf("%s:%u: bad report, skipped\n", path, lineno);
+            continue;
+        }
+        r->adv_len = adv;
+        r->rsp_len = rsp;
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+// Everything the challenges do with a report. Returns a value that depends
+// on every decoded field so none of the work can be optimised away.
+static uint32_t decode(const bench_report_t *r, bench_counts_t *counts) {
+    ble_adv_info_t info;
+    uint32_t sum = 0;
+
+    ble_adv_info_init(&info);
+    bool ok = ble_adv_parse(&info, r->adv, r->adv_len) == ESP_OK;
+    ok &= ble_adv_parse(&info, r->rsp, r->rsp_len) == ESP_OK;
+    sum += info.num_ad + info.flags + info.num_uuid16 + info.num_uuid128 + info.tx_power;
+    if (info.name) sum += info.name_len + info.name[0];
+
+    ble_ibeacon_t beacon;
+    ble_eddystone_t eddystone;
+    ble_continuity_iter_t it;
+    if (ble_adv_ibeacon(&info, &beacon)) {
+        sum += beacon.major + beacon.minor + beacon.uuid[0];
+        if (counts) counts->ibeacon++;
+    } else if (ble_adv_eddystone(&info, &eddystone)) {
+        if (eddystone.frame == BLE_EDDYSTONE_URL) {
+            char url[64];
+            sum += ble_eddystone_url(&eddystone, url, sizeof(url));
+        } else if (eddystone.frame == BLE_EDDYSTONE_TLM) {
+            sum += eddystone.tlm.battery_mv + eddystone.tlm.adv_count;
+        }
+        if (counts) counts->eddystone++;
+    } else if (ble_continuity_iter_init(&it, &info)) {
+        uint8_t type, len;
+        const uint8_t *data;
+        while (ble_continuity_next(&it, &type, &data, &len)) {
+            sum += type + len;
+        }
+        if (counts) counts->continuity++;
+    }
+
+    if (counts) {
+        counts->malformed += !ok;
+        counts->named += info.name != NULL;
+    }
+    return sum;
+}
+
+void app_main(void) {
+    const char *path = getenv("BENCH_CORPUS");
+    if (path == NULL) path = "corpus/reports.txt";
+    unsigned long loops = env_ulong("BENCH_LOOPS", 100000);
+    unsigned long min_rate = env_ulong("BENCH_MIN_RATE", 0);
+
+    size_t num_reports = load_corpus(path);
+    if (num_reports == 0) {
+        printf("No reports loaded from %s\n", path);
+        exit(2);
+    }
+
+    bench_counts_t counts = {0};
+    for (size_t i = 0; i < num_reports; i++) {
+        decode(&reports[i], &counts);
+    }
+
+    volatile uint32_t sink = 0;
+    uint64_t start = now_ns();
+    for (unsigned long loop = 0; loop < loops; loop++) {
+        for (size_t i = 0; i < num_reports; i++) {
+            sink += decode(&reports[i], NULL);
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double total = (double)num_reports * loops;
+    double rate = elapsed ? total * 1e9 / elapsed : 0;
+    printf("\n=== BLE Advertising Parser Benchmark ===\n");
+    printf("Corpus:            %s (%zu reports x %lu loops)\n", path, num_reports, loops);
+    printf("Named:             %lu\n", counts.named);
+    printf("iBeacon:           %lu\n", counts.ibeacon);
+    printf("Eddystone:         %lu\n", counts.eddystone);
+    printf("Apple Continuity:  %lu\n", counts.continuity);
+    printf("Malformed:         %lu\n", counts.malformed);
+    printf("Parsed:            %.0f reports in %.3f s (%.0f reports/s, %.1f ns each)\n",
+           total, elapsed / 1e9, rate, total ? elapsed / total : 0);
+
+    bool failed = false;
+    if (min_rate && rate < min_rate) {
+        printf("FAIL: %.0f reports/s is below BENCH_MIN_RATE=%lu\n", rate, min_rate);
+        failed = true;
+    }
+    exit(failed ? 1 : 0);
+}
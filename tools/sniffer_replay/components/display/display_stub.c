@@ -0,0 +1,8 @@
+// tools/sniffer_replay/components/display/display_stub.c
+#include "display.h"
+
+void display_show_bar_chart(const char *title, const uint8_t *values, size_t count) {
+    (void)title;
+    (void)values;
+    (void)count;
+}
@@ -0,0 +1,8 @@
+// tools/sniffer_replay/components/display/include/display.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Only the calls made by the network module are provided
+void display_show_bar_chart(const char *title, const uint8_t *values, size_t count);
@@ -0,0 +1,49 @@
+// tools/sniffer_replay/components/esp_wifi/esp_wifi_stub.c
+#include "esp_wifi.h"
+
+static wifi_promiscuous_cb_t rx_cb = NULL;
+static uint32_t filter_mask = WIFI_PROMIS_FILTER_MASK_ALL;
+static volatile bool promiscuous = false;
+static uint8_t channel = 1;
+
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t *filter) {
+    if (filter == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    filter_mask = filter->filter_mask;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb) {
+    rx_cb = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous(bool en) {
+    promiscuous = en;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+    (void)second;
+    if (primary < 1 || primary > 14) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channel = primary;
+    return ESP_OK;
+}
+
+void esp_wifi_stub_deliver(wifi_promiscuous_pkt_t *pkt, wifi_promiscuous_pkt_type_t type) {
+    if (!promiscuous || rx_cb == NULL || !(filter_mask & (1u << type))) {
+        return;
+    }
+    rx_cb(pkt, type);
+}
+
+bool esp_wifi_stub_promiscuous_enabled(void) {
+    return promiscuous;
+}
+
+uint8_t esp_wifi_stub_get_channel(void) {
+    return channel;
+}
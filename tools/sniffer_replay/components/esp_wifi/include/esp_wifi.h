@@ -0,0 +1,21 @@
+// tools/sniffer_replay/components/esp_wifi/include/esp_wifi.h
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t *filter);
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb);
+esp_err_t esp_wifi_set_promiscuous(bool en);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+
+// Harness side: deliver one frame the way the driver would. Frames are
+// dropped unless promiscuous mode is on and the filter mask admits them.
+void esp_wifi_stub_deliver(wifi_promiscuous_pkt_t *pkt, wifi_promiscuous_pkt_type_t type);
+
+// True once the module under test has enabled promiscuous capture
+bool esp_wifi_stub_promiscuous_enabled(void);
+
+// Channel most recently selected with esp_wifi_set_channel
+uint8_t esp_wifi_stub_get_channel(void);
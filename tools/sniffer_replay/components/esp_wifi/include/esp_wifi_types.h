@@ -0,0 +1,84 @@
+// tools/sniffer_replay/components/esp_wifi/include/esp_wifi_types.h
+#pragma once
+
+#include <stdint.h>
+
+// Subset of the ESP32 WiFi driver types used by the network module.
+// wifi_pkt_rx_ctrl_t follows the ESP32 (non-C5/C6) bit layout.
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_ENTERPRISE,
+    WIFI_AUTH_WPA3_PSK,
+    WIFI_AUTH_WPA2_WPA3_PSK,
+    WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum {
+    WIFI_SECOND_CHAN_NONE = 0,
+    WIFI_SECOND_CHAN_ABOVE,
+    WIFI_SECOND_CHAN_BELOW
+} wifi_second_chan_t;
+
+typedef struct {
+    signed rssi: 8;
+    unsigned rate: 5;
+    unsigned : 1;
+    unsigned sig_mode: 2;
+    unsigned : 16;
+    unsigned mcs: 7;
+    unsigned cwb: 1;
+    unsigned : 16;
+    unsigned smoothing: 1;
+    unsigned not_sounding: 1;
+    unsigned : 1;
+    unsigned aggregation: 1;
+    unsigned stbc: 2;
+    unsigned fec_coding: 1;
+    unsigned sgi: 1;
+    signed noise_floor: 8;
+    unsigned ampdu_cnt: 8;
+    unsigned channel: 4;
+    unsigned secondary_channel: 4;
+    unsigned : 8;
+    unsigned timestamp: 32;
+    unsigned : 32;
+    unsigned : 31;
+    unsigned ant: 1;
+    unsigned sig_len: 12;
+    unsigned : 12;
+    unsigned rx_state: 8;
+} wifi_pkt_rx_ctrl_t;
+
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t payload[0];
+} wifi_promiscuous_pkt_t;
+
+typedef enum {
+    WIFI_PKT_MGMT,
+    WIFI_PKT_CTRL,
+    WIFI_PKT_DATA,
+    WIFI_PKT_MISC
+} wifi_promiscuous_pkt_type_t;
+
+#define WIFI_PROMIS_FILTER_MASK_ALL     (0xFFFFFFFF)
+#define WIFI_PROMIS_FILTER_MASK_MGMT    (1)
+#define WIFI_PROMIS_FILTER_MASK_CTRL    (1 << 1)
+#define WIFI_PROMIS_FILTER_MASK_DATA    (1 << 2)
+#define WIFI_PROMIS_FILTER_MASK_MISC    (1 << 3)
+
+typedef struct {
+    uint32_t filter_mask;
+} wifi_promiscuous_filter_t;
+
+typedef void (*wifi_promiscuous_cb_t)(void *buf, wifi_promiscuous_pkt_type_t type);
+
+#ifndef MACSTR
+#define MACSTR "%02x:%02x:%02x:%02x:%02x:%02x"
+#define MAC2STR(a) (a)[0], (a)[1], (a)[2], (a)[3], (a)[4], (a)[5]
+#endif
@@ -0,0 +1,247 @@
+// tools/sniffer_replay/main/pcap_reader.c
+#include "pcap_reader.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "pcap_reader";
+
+#define PCAP_MAGIC_USEC         0xa1b2c3d4
+#define PCAP_MAGIC_NSEC         0xa1b23c4d
+#define LINKTYPE_IEEE802_11     105
+#define LINKTYPE_RADIOTAP       127
+
+// rx_ctrl.sig_len is 12 bits wide
+#define MAX_FRAME_LEN           4095
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+} pcap_file_hdr_t;
+
+typedef struct {
+    uint32_t ts_sec;
+    uint32_t ts_frac;
+    uint32_t incl_len;
+    uint32_t orig_len;
+} pcap_rec_hdr_t;
+
+// Radiotap fields of the first present word: {size, alignment}
+static const uint8_t radiotap_fields[][2] = {
+    {8, 8},     // 0  TSFT
+    {1, 1},     // 1  Flags
+    {1, 1},     // 2  Rate
+    {4, 2},     // 3  Channel
+    {2, 1},     // 4  FHSS
+    {1, 1},     // 5  Antenna signal (dBm)
+    {1, 1},     // 6  Antenna noise (dBm)
+    {2, 2},     // 7  Lock quality
+    {2, 2},     // 8  TX attenuation
+    {2, 2},     // 9  TX attenuation (dB)
+    {1, 1},     // 10 TX power (dBm)
+    {1, 1},     // 11 Antenna
+    {1, 1},     // 12 Antenna signal (dB)
+    {1, 1},     // 13 Antenna noise (dB)
+    {2, 2},     // 14 RX flags
+    {2, 2},     // 15 TX flags
+    {1, 1},     // 16 RTS retries
+    {1, 1},     // 17 Data retries
+    {8, 4},     // 18 XChannel
+    {3, 1},     // 19 MCS
+};
+
+static uint32_t swap32(uint32_t v) {
+    return __builtin_bswap32(v);
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Legacy rate in 500 kbps units to the driver's PHY rate code
+static uint8_t legacy_rate_code(uint8_t rate) {
+    switch (rate) {
+        case 2:   return 0x00;  // 1 Mbps
+        case 4:   return 0x01;  // 2 Mbps
+        case 11:  return 0x02;  // 5.5 Mbps
+        case 22:  return 0x03;  // 11 Mbps
+        case 12:  return 0x0B;  // 6 Mbps
+        case 18:  return 0x0F;  // 9 Mbps
+        case 24:  return 0x0A;  // 12 Mbps
+        case 36:  return 0x0E;  // 18 Mbps
+        case 48:  return 0x09;  // 24 Mbps
+        case 72:  return 0x0D;  // 36 Mbps
+        case 96:  return 0x08;  // 48 Mbps
+        case 108: return 0x0C;  // 54 Mbps
+        default:  return 0x00;
+    }
+}
+
+static uint8_t freq_to_channel(uint16_t freq) {
+    if (freq == 2484) return 14;
+    if (freq >= 2412 && freq <= 2472) return (freq - 2407) / 5;
+    return 0;
+}
+
+// Parse a radiotap header into rx_ctrl. Returns the header length, or 0 if
+// the header is malformed.
+static size_t parse_radiotap(const uint8_t *data, size_t len, wifi_pkt_rx_ctrl_t *rx_ctrl) {
+    if (len < 8) return 0;
+
+    size_t hdr_len = get_le16(data + 2);
+    if (hdr_len > len) return 0;
+
+    uint32_t present = get_le32(data + 4);
+    size_t off = 8;
+    // Skip extended present words
+    for (uint32_t word = present; word & 0x80000000; ) {
+        if (off + 4 > hdr_len) return 0;
+        word = get_le32(data + off);
+        off += 4;
+    }
+
+    for (int bit = 0; bit < (int)(sizeof(radiotap_fields) / sizeof(radiotap_fields[0])); bit++) {
+        if (!(present & (1u << bit))) continue;
+
+        uint8_t size = radiotap_fields[bit][0];
+        uint8_t align = radiotap_fields[bit][1];
+        off = (off + align - 1) & ~(size_t)(align - 1);
+        if (off + size > hdr_len) break;
+
+        const uint8_t *f = data + off;
+        switch (bit) {
+            case 2:
+                rx_ctrl->rate = legacy_rate_code(f[0]);
+                break;
+            case 3:
+                rx_ctrl->channel = freq_to_channel(get_le16(f));
+                break;
+            case 5:
+                rx_ctrl->rssi = (int8_t)f[0];
+                break;
+            case 6:
+                rx_ctrl->noise_floor = (int8_t)f[0];
+                break;
+            case 19:
+                // known, flags, index
+                rx_ctrl->sig_mode = 1;
+                rx_ctrl->mcs = f[2] & 0x7F;
+                rx_ctrl->cwb = (f[1] & 0x03) == 1;
+                rx_ctrl->sgi = (f[1] >> 2) & 0x01;
+                break;
+        }
+        off += size;
+    }
+
+    return hdr_len;
+}
+
+static wifi_promiscuous_pkt_type_t frame_type(const uint8_t *frame) {
+    switch ((frame[0] >> 2) & 0x03) {
+        case 0:  return WIFI_PKT_MGMT;
+        case 1:  return WIFI_PKT_CTRL;
+        case 2:  return WIFI_PKT_DATA;
+        default: return WIFI_PKT_MISC;
+    }
+}
+
+esp_err_t pcap_load(const char *path, replay_frame_t **frames_out, size_t *num_out) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Cannot open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    pcap_file_hdr_t fh;
+    if (fread(&fh, sizeof(fh), 1, f) != 1) {
+        fclose(f);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    bool swapped = false;
+    if (fh.magic == swap32(PCAP_MAGIC_USEC) || fh.magic == swap32(PCAP_MAGIC_NSEC)) {
+        swapped = true;
+        fh.linktype = swap32(fh.linktype);
+    } else if (fh.magic != PCAP_MAGIC_USEC && fh.magic != PCAP_MAGIC_NSEC) {
+        ESP_LOGE(TAG, "%s is not a pcap file", path);
+        fclose(f);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (fh.linktype != LINKTYPE_RADIOTAP && fh.linktype != LINKTYPE_IEEE802_11) {
+        ESP_LOGE(TAG, "Unsupported link type %lu", (unsigned long)fh.linktype);
+        fclose(f);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    size_t capacity = 1024, count = 0;
+    replay_frame_t *frames = malloc(capacity * sizeof(*frames));
+    uint8_t *data = malloc(65536);
+    if (frames == NULL || data == NULL) {
+        free(frames);
+        free(data);
+        fclose(f);
+        return ESP_ERR_NO_MEM;
+    }
+
+    pcap_rec_hdr_t rh;
+    while (fread(&rh, sizeof(rh), 1, f) == 1) {
+        uint32_t incl_len = swapped ? swap32(rh.incl_len) : rh.incl_len;
+        if (incl_len > 65536 || fread(data, 1, incl_len, f) != incl_len) break;
+
+        wifi_pkt_rx_ctrl_t rx_ctrl = {
+            .rssi = -60,
+            .noise_floor = -95,
+            .channel = 1
+        };
+        size_t hdr_len = 0;
+        if (fh.linktype == LINKTYPE_RADIOTAP) {
+            hdr_len = parse_radiotap(data, incl_len, &rx_ctrl);
+            if (hdr_len == 0) continue;
+        }
+
+        size_t frame_len = incl_len - hdr_len;
+        if (frame_len < 10 || frame_len > MAX_FRAME_LEN) continue;
+
+        if (count == capacity) {
+            replay_frame_t *grown = realloc(frames, capacity * 2 * sizeof(*frames));
+            if (grown == NULL) break;
+            frames = grown;
+            capacity *= 2;
+        }
+
+        wifi_promiscuous_pkt_t *pkt = malloc(sizeof(*pkt) + frame_len);
+        if (pkt == NULL) break;
+        pkt->rx_ctrl = rx_ctrl;
+        pkt->rx_ctrl.sig_len = frame_len;
+        memcpy(pkt->payload, data + hdr_len, frame_len);
+
+        frames[count].type = frame_type(pkt->payload);
+        frames[count].pkt = pkt;
+        count++;
+    }
+
+    free(data);
+    fclose(f);
+
+    *frames_out = frames;
+    *num_out = count;
+    return ESP_OK;
+}
+
+void pcap_free(replay_frame_t *frames, size_t num_frames) {
+    for (size_t i = 0; i < num_frames; i++) {
+        free(frames[i].pkt);
+    }
+    free(frames);
+}
@@ -0,0 +1,19 @@
+// tools/sniffer_replay/main/pcap_reader.h
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+// Frame converted to what the WiFi driver hands the promiscuous callback
+typedef struct {
+    wifi_promiscuous_pkt_type_t type;
+    wifi_promiscuous_pkt_t *pkt;        // rx_ctrl followed by the 802.11 frame
+} replay_frame_t;
+
+// Load every 802.11 frame of a pcap file. Radiotap (linktype 127) and bare
+// 802.11 (linktype 105) captures are supported; radiotap channel, rate,
+// MCS, signal and noise fields are mapped onto rx_ctrl.
+esp_err_t pcap_load(const char *path, replay_frame_t **frames, size_t *num_frames);
+
+void pcap_free(replay_frame_t *frames, size_t num_frames);
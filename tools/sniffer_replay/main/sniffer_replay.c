@@ -0,0 +1,143 @@
+// tools/sniffer_replay/main/sniffer_replay.c
+//
+// Replays a pcap/radiotap capture through the network module's promiscuous
+// callback on the host and reports sniffer pipeline throughput.
+//
+//   idf.py --preview set-target linux && idf.py build
+//   REPLAY_PCAP=capture.pcap ./build/sniffer_replay.elf
+//
+// Environment:
+//   REPLAY_PCAP       capture to replay (required)
+//   REPLAY_CHALLENGE  "packet" (default), "beacon" or "survey"
+//   REPLAY_RATE       frames per second to offer, 0 = as fast as possible
+//   REPLAY_LOOPS      number of passes over the capture (default 1)
+//   REPLAY_MIN_FPS    fail (exit 1) if delivered frames/s falls below this
+//   REPLAY_MAX_DROPS  fail (exit 1) if more frames than this are dropped
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "network_challenges.h"
+#include "pcap_reader.h"
+
+static const char *TAG = "sniffer_replay";
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long env_ulong(const char *name, unsigned long fallback) {
+    const char *value = getenv(name);
+    return value ? strtoul(value, NULL, 10) : fallback;
+}
+
+void app_main(void) {
+    const char *path = getenv("REPLAY_PCAP");
+    if (path == NULL) {
+        printf("REPLAY_PCAP is not set\n");
+        exit(2);
+    }
+
+    const char *challenge_name = getenv("REPLAY_CHALLENGE");
+    network_challenge_type_t challenge = NET_CHALLENGE_PACKET_ANALYSIS;
+    if (challenge_name && strcmp(challenge_name, "beacon") == 0) {
+        challenge = NET_CHALLENGE_BEACON_ANALYSIS;
+    } else if (challenge_name && strcmp(challenge_name, "survey") == 0) {
+        challenge = NET_CHALLENGE_CHANNEL_SURVEY;
+    }
+
+    unsigned long rate = env_ulong("REPLAY_RATE", 0);
+    unsigned long loops = env_ulong("REPLAY_LOOPS", 1);
+    unsigned long min_fps = env_ulong("REPLAY_MIN_FPS", 0);
+    unsigned long max_drops = env_ulong("REPLAY_MAX_DROPS", (unsigned long)-1);
+
+    replay_frame_t *frames;
+    size_t num_frames;
+    if (pcap_load(path, &frames, &num_frames) != ESP_OK || num_frames == 0) {
+        printf("No 802.11 frames loaded from %s\n", path);
+        exit(2);
+    }
+
+    ESP_ERROR_CHECK(network_challenges_init());
+    ESP_ERROR_CHECK(start_network_challenge(challenge));
+    while (!esp_wifi_stub_promiscuous_enabled()) {
+        vTaskDelay(1);
+    }
+
+    // Feed frames from this task, standing in for the WiFi driver task
+    uint64_t cb_total_ns = 0, cb_max_ns = 0;
+    uint64_t offered = 0;
+    uint64_t start = now_ns();
+    for (unsigned long loop = 0; loop < loops; loop++) {
+        for (size_t i = 0; i < num_frames; i++, offered++) {
+            if (rate > 0) {
+                uint64_t due = start + offered * 1000000000ULL / rate;
+                while (now_ns() < due) {
+                    if (due - now_ns() > portTICK_PERIOD_MS * 1000000ULL) vTaskDelay(1);
+                }
+            }
+
+            uint64_t t0 = now_ns();
+            esp_wifi_stub_deliver(frames[i].pkt, frames[i].type);
+            uint64_t spent = now_ns() - t0;
+            cb_total_ns += spent;
+            if (spent > cb_max_ns) cb_max_ns = spent;
+        }
+    }
+    uint64_t feed_end = now_ns();
+
+    // Let the analysis task drain the queue
+    network_capture_stats_t stats;
+    for (int wait = 0; wait < 100; wait++) {
+        network_get_capture_stats(&stats);
+        if (stats.frames_processed + stats.frames_dropped >= stats.frames_accepted) break;
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    uint64_t drain_end = now_ns();
+    network_get_capture_stats(&stats);
+
+    double feed_s = (feed_end - start) / 1e9;
+    double total_s = (drain_end - start) / 1e9;
+    double fps = stats.frames_processed / total_s;
+
+    printf("\n=== Sniffer Replay Report ===\n");
+    printf("Capture:           %s (%zu frames x %lu loops)\n", path, num_frames, loops);
+    printf("Challenge:         %s\n", challenge_name ? challenge_name : "packet");
+    printf("Offered rate:      %s\n", rate ? "paced" : "maximum");
+    printf("Frames offered:    %llu in %.3f s (%.0f frames/s)\n",
+           (unsigned long long)offered, feed_s, offered / feed_s);
+    printf("Frames seen:       %lu\n", (unsigned long)stats.frames_seen);
+    printf("Frames accepted:   %lu\n", (unsigned long)stats.frames_accepted);
+    printf("Frames processed:  %lu (%.0f frames/s)\n", (unsigned long)stats.frames_processed, fps);
+    printf("Frames dropped:    %lu\n", (unsigned long)stats.frames_dropped);
+    printf("Queue high-water:  %lu\n", (unsigned long)stats.queue_high_water);
+    printf("Callback:          avg %.2f us, max %.2f us\n",
+           stats.frames_seen ? cb_total_ns / 1e3 / stats.frames_seen : 0.0, cb_max_ns / 1e3);
+    printf("Queue wait:        avg %.2f us, max %lu us\n",
+           stats.frames_processed ? (double)stats.queue_time_total_us / stats.frames_processed : 0.0,
+           (unsigned long)stats.queue_time_max_us);
+    printf("Analysis:          avg %.2f us, max %lu us\n",
+           stats.frames_processed ? (double)stats.process_time_total_us / stats.frames_processed : 0.0,
+           (unsigned long)stats.process_time_max_us);
+
+    bool failed = false;
+    if (min_fps && fps < min_fps) {
+        printf("FAIL: %.0f frames/s is below REPLAY_MIN_FPS=%lu\n", fps, min_fps);
+        failed = true;
+    }
+    if (stats.frames_dropped > max_drops) {
+        printf("FAIL: %lu drops exceeds REPLAY_MAX_DROPS=%lu\n",
+               (unsigned long)stats.frames_dropped, max_drops);
+        failed = true;
+    }
+
+    ESP_LOGI(TAG, "Replay finished");
+    pcap_free(frames, num_frames);
+    exit(failed ? 1 : 0);
+}
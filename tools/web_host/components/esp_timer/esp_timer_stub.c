@@ -0,0 +1,15 @@
+// tools/web_host/components/esp_timer/esp_timer_stub.c
+#include "esp_timer.h"
+#include <time.h>
+
+static int64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void) {
+    static int64_t boot_us = 0;
+    if (boot_us == 0) boot_us = now_us();
+    return now_us() - boot_us;
+}
@@ -0,0 +1,7 @@
+// tools/web_host/components/esp_timer/include/esp_timer.h
+#pragma once
+
+#include <stdint.h>
+
+// Microseconds since the harness started (CLOCK_MONOTONIC)
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,87 @@
+// tools/web_host/components/heap/heap_stub.c
+#include "esp_heap_caps.h"
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+// Bytes in use and the high-water mark. Signed: blocks allocated inside
+// libc bypass the wrappers but may still be freed through them.
+static atomic_long used = 0;
+static atomic_long peak = 0;
+
+static void account(long delta) {
+    long now = atomic_fetch_add(&used, delta) + delta;
+    long high = atomic_load(&peak);
+    while (now > high && !atomic_compare_exchange_weak(&peak, &high, now)) {
+    }
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    if (ptr) account(malloc_usable_size(ptr));
+    return ptr;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    void *ptr = __real_calloc(n, size);
+    if (ptr) account(malloc_usable_size(ptr));
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    long old = ptr ? (long)malloc_usable_size(ptr) : 0;
+    void *out = __real_realloc(ptr, size);
+    if (out) {
+        account((long)malloc_usable_size(out) - old);
+    } else if (size == 0) {
+        account(-old);
+    }
+    return out;
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr) account(-(long)malloc_usable_size(ptr));
+    __real_free(ptr);
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    return calloc(n, size);
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+    return realloc(ptr, size);
+}
+
+void heap_caps_free(void *ptr) {
+    free(ptr);
+}
+
+static size_t free_below(long in_use) {
+    if (in_use < 0) in_use = 0;
+    return in_use >= HOST_HEAP_SIZE ? 0 : HOST_HEAP_SIZE - in_use;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+    return HOST_HEAP_SIZE;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return free_below(atomic_load(&used));
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    return free_below(atomic_load(&peak));
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return heap_caps_get_free_size(caps);
+}
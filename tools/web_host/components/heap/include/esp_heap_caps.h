@@ -0,0 +1,26 @@
+// tools/web_host/components/heap/include/esp_heap_caps.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The host has one heap; capabilities are accepted and ignored
+#define MALLOC_CAP_32BIT        (1 << 1)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+// Notional heap size, roughly the free DRAM of a device running WiFi, so
+// "free" figures look like the device's. Use is tracked exactly.
+#define HOST_HEAP_SIZE          (200 * 1024)
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void heap_caps_free(void *ptr);
+
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+# tools/web_loadgen.py
+#
+# Load generator for the web challenge server. Runs concurrent keep-alive
+# clients against the challenge endpoints, optionally alongside "trickle"
+# clients that send their request body a byte at a time, and reports
+# throughput, latency percentiles, status codes and the server's heap use
+# (from /status).
+#
+#   python3 tools/web_loadgen.py --clients 10 --duration 10
+#   python3 tools/web_loadgen.py --clients 8 --trickle 2 --min-rps 50
+#   python3 tools/web_loadgen.py --host 127.0.0.1 --port 8080 --max-p99-ms 20
+#
+# The last form targets the host build in tools/web_host.
+import argparse
+import http.client
+import json
+import socket
+import sys
+import threading
+import time
+from collections import Counter
+
+REQUESTS = {
+    'index': ('GET', '/', None),
+    'auth': ('POST', '/auth', {'username': 'admin', 'password': 'password'}),
+    'query': ('POST', '/query', {'query': "1 OR '1'='1'"}),
+    'message': ('POST', '/message', {'message': '<b>hello</b>'}),
+    'timing': ('POST', '/timing', {'guesses': ['Secret', 'SecretPassword123']}),
+}
+
+
+class Results:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.status = Counter()
+        self.errors = Counter()
+        self.latencies = []
+
+    def record(self, status, latency):
+        with self.lock:
+            self.status[status] += 1
+            self.latencies.append(latency)
+
+    def error(self, kind):
+        with self.lock:
+            self.errors[kind] += 1
+
+
+def percentile(sorted_values, pct):
+    # Nearest-rank percentile of an already sorted list
+    rank = max(1, -(-len(sorted_values) * pct // 100))
+    return sorted_values[int(rank) - 1]
+
+
+def heap_status(args):
+    # Free and lowest-ever free heap bytes reported by the server, or None
+    try:
+        conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+        conn.request('GET', '/status')
+        heap = json.loads(conn.getresponse().read())['heap']
+        conn.close()
+        return heap['free'], heap['min_free']
+    except (OSError, http.client.HTTPException, ValueError, KeyError):
+        return None
+
+
+def client(args, names, deadline, results, index):
+    conn = None
+    i = index
+    while time.monotonic() < deadline:
+        method, path, body = REQUESTS[names[i % len(names)]]
+        i += 1
+        payload = json.dumps(body).encode() if body is not None else None
+        headers = {'Content-Type': 'application/json'} if payload else {}
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+            start = time.monotonic()
+            conn.request(method, path, body=payload, headers=headers)
+            resp = conn.getresponse()
+            resp.read()
+            results.record(resp.status, time.monotonic() - start)
+            if not args.keepalive or resp.getheader('Connection', '').lower() == 'close':
+                conn.close()
+                conn = None
+        except (OSError, http.client.HTTPException) as exc:
+            results.error(type(exc).__name__)
+            if conn is not None:
+                conn.close()
+            conn = None
+    if conn is not None:
+        conn.close()
+
+
+def trickle(args, deadline, results):
+    # Declares a body and then sends it one byte per interval, holding a
+    # server-side handler for as long as possible
+    body = json.dumps({'message': 'x' * 48}).encode()
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection((args.host, args.port), timeout=args.timeout) as sock:
+                sock.sendall(('POST /message HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n'
+                              'Content-Length: %d\r\n\r\n' % (args.host, len(body))).encode())
+                for b in body:
+                    if time.monotonic() >= deadline:
+                        return
+                    sock.sendall(bytes([b]))
+                    time.sleep(args.trickle_interval)
+                sock.recv(4096)
+        except OSError as exc:
+            results.error('trickle ' + type(exc).__name__)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Web challenge load generator')
+    parser.add_argument('--host', default='192.168.4.1')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--clients', type=int, default=10, help='concurrent keep-alive clients')
+    parser.add_argument('--duration', type=float, default=10.0, help='seconds')
+    parser.add_argument('--mix', default='auth,query,message,index',
+                        help='comma-separated requests to cycle through: %s' % ','.join(REQUESTS))
+    parser.add_argument('--trickle', type=int, default=0, help='slow clients trickling a body')
+    parser.add_argument('--trickle-interval', type=float, default=0.5, help='seconds per byte')
+    parser.add_argument('--timeout', type=float, default=10.0, help='socket timeout')
+    parser.add_argument('--no-keepalive', dest='keepalive', action='store_false',
+                        help='open a new connection for every request')
+    parser.add_argument('--min-rps', type=float, default=0, help='exit 1 below this throughput')
+    parser.add_argument('--max-p99-ms', type=float, default=0, help='exit 1 above this p99 latency')
+    parser.add_argument('--max-heap', type=int, default=0,
+                        help='exit 1 if the server heap use grows by more than this many bytes')
+    args = parser.parse_args()
+
+    names = [n for n in args.mix.split(',') if n]
+    unknown = [n for n in names if n not in REQUESTS]
+    if not names or unknown:
+        parser.error('unknown request in --mix: %s' % ','.join(unknown))
+
+    heap_before = heap_status(args)
+    results = Results()
+    start = time.monotonic()
+    deadline = start + args.duration
+    threads = [threading.Thread(target=client, args=(args, names, deadline, results, i))
+               for i in range(args.clients)]
+    threads += [threading.Thread(target=trickle, args=(args, deadline, results))
+                for _ in range(args.trickle)]
+    for t in threads:
+        t.daemon = True
+        t.start()
+    for t in threads:
+        t.join(args.duration + args.timeout + 1)
+    elapsed = time.monotonic() - start
+    heap_after = heap_status(args)
+
+    total = sum(results.status.values())
+    ok = sum(n for s, n in results.status.items() if s < 400)
+    rps = total / elapsed
+    lat = sorted(results.latencies)
+    p99 = 1000 * percentile(lat, 99) if lat else 0
+    print('Target:      http://%s:%d/ (%d clients%s, %d trickling, mix %s)'
+          % (args.host, args.port, args.clients, '' if args.keepalive else ' without keep-alive',
+             args.trickle, ','.join(names)))
+    print('Requests:    %d in %.1f s, %.1f req/s, %d OK' % (total, elapsed, rps, ok))
+    if lat:
+        print('Latency:     avg %.1f ms, p50 %.1f ms, p99 %.1f ms, max %.1f ms'
+              % (1000 * sum(lat) / len(lat), 1000 * percentile(lat, 50), p99, 1000 * lat[-1]))
+    heap_peak = None
+    if heap_before and heap_after:
+        # min_free is a lifetime low-water mark, so this is the peak use above
+        # the pre-run level, or 0 if the run never went below an earlier low
+        heap_peak = max(0, heap_before[0] - heap_after[1])
+        print('Heap:        %d free before, %d after, peak +%d bytes during run'
+              % (heap_before[0], heap_after[0], heap_peak))
+    else:
+        print('Heap:        /status unavailable')
+    print('Status:      %s' % ', '.join('%d x%d' % (s, n) for s, n in sorted(results.status.items())))
+    if results.errors:
+        print('Errors:      %s' % ', '.join('%s x%d' % (e, n) for e, n in sorted(results.errors.items())))
+
+    failed = False
+    if args.min_rps and rps < args.min_rps:
+        print('FAIL: %.1f req/s is below --min-rps %.1f' % (rps, args.min_rps))
+        failed = True
+    if args.max_p99_ms and p99 > args.max_p99_ms:
+        print('FAIL: p99 %.1f ms is above --max-p99-ms %.1f' % (p99, args.max_p99_ms))
+        failed = True
+    if args.max_heap and (heap_peak is None or heap_peak > args.max_heap):
+        print('FAIL: heap peak %s is above --max-heap %d' % (heap_peak, args.max_heap))
+        failed = True
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()